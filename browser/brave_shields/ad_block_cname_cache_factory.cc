@@ -0,0 +1,44 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/brave_shields/ad_block_cname_cache_factory.h"
+
+#include "brave/components/brave_shields/browser/ad_block_cname_cache.h"
+#include "chrome/browser/profiles/incognito_helpers.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+
+namespace brave_shields {
+
+// static
+AdBlockCnameCache* AdBlockCnameCacheFactory::GetForBrowserContext(
+    content::BrowserContext* context) {
+  return static_cast<AdBlockCnameCache*>(
+      GetInstance()->GetServiceForBrowserContext(context,
+                                                 /*create_service=*/true));
+}
+
+// static
+AdBlockCnameCacheFactory* AdBlockCnameCacheFactory::GetInstance() {
+  return base::Singleton<AdBlockCnameCacheFactory>::get();
+}
+
+AdBlockCnameCacheFactory::AdBlockCnameCacheFactory()
+    : BrowserContextKeyedServiceFactory(
+          "AdBlockCnameCache",
+          BrowserContextDependencyManager::GetInstance()) {}
+
+AdBlockCnameCacheFactory::~AdBlockCnameCacheFactory() {}
+
+content::BrowserContext* AdBlockCnameCacheFactory::GetBrowserContextToUse(
+    content::BrowserContext* context) const {
+  return chrome::GetBrowserContextOwnInstanceInIncognito(context);
+}
+
+KeyedService* AdBlockCnameCacheFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new AdBlockCnameCache();
+}
+
+}  // namespace brave_shields
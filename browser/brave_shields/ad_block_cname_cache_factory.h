@@ -0,0 +1,43 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_BRAVE_SHIELDS_AD_BLOCK_CNAME_CACHE_FACTORY_H_
+#define BRAVE_BROWSER_BRAVE_SHIELDS_AD_BLOCK_CNAME_CACHE_FACTORY_H_
+
+#include "base/memory/singleton.h"
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+
+namespace brave_shields {
+
+class AdBlockCnameCache;
+
+class AdBlockCnameCacheFactory : public BrowserContextKeyedServiceFactory {
+ public:
+  static AdBlockCnameCache* GetForBrowserContext(
+      content::BrowserContext* context);
+
+  static AdBlockCnameCacheFactory* GetInstance();
+
+ private:
+  friend struct base::DefaultSingletonTraits<AdBlockCnameCacheFactory>;
+
+  AdBlockCnameCacheFactory();
+  ~AdBlockCnameCacheFactory() override;
+
+  // BrowserContextKeyedServiceFactory:
+
+  // Canonical names resolved in an off-the-record profile must not outlive
+  // it, so it gets a cache of its own.
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override;
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockCnameCacheFactory);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_BROWSER_BRAVE_SHIELDS_AD_BLOCK_CNAME_CACHE_FACTORY_H_
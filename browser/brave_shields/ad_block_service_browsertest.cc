@@ -109,8 +109,8 @@ void AdBlockServiceTest::AssertTagExists(const std::string& tag,
   ASSERT_EQ(exists_default, expected_exists);
 
   for (const auto& regional_service :
-       g_brave_browser_process->ad_block_regional_service_manager()
-           ->regional_services_) {
+       *g_brave_browser_process->ad_block_regional_service_manager()
+            ->GetRegionalServices()) {
     bool exists_regional = regional_service.second->TagExists(tag);
     ASSERT_EQ(exists_regional, expected_exists);
   }
@@ -195,13 +195,12 @@ bool AdBlockServiceTest::InstallRegionalAdBlockExtension(
 
   g_brave_browser_process->ad_block_regional_service_manager()
       ->EnableFilterList(uuid, true);
-  EXPECT_EQ(g_brave_browser_process->ad_block_regional_service_manager()
-                ->regional_services_.size(),
-            1ULL);
-
-  auto regional_service =
+  auto regional_services =
       g_brave_browser_process->ad_block_regional_service_manager()
-          ->regional_services_.find(uuid);
+          ->GetRegionalServices();
+  EXPECT_EQ(regional_services->size(), 1ULL);
+
+  auto regional_service = regional_services->find(uuid);
   regional_service->second->OnComponentReady(ad_block_extension->id(),
                                              ad_block_extension->path(), "");
   WaitForAdBlockServiceThreads();
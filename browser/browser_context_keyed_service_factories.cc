@@ -6,6 +6,7 @@
 #include "brave/browser/browser_context_keyed_service_factories.h"
 
 #include "brave/browser/brave_rewards/rewards_service_factory.h"
+#include "brave/browser/brave_shields/ad_block_cname_cache_factory.h"
 #include "brave/browser/brave_shields/ad_block_pref_service_factory.h"
 #include "brave/browser/brave_shields/cookie_pref_service_factory.h"
 #include "brave/browser/ntp_background_images/view_counter_service_factory.h"
@@ -44,6 +45,7 @@ namespace brave {
 void EnsureBrowserContextKeyedServiceFactoriesBuilt() {
   brave_ads::AdsServiceFactory::GetInstance();
   brave_rewards::RewardsServiceFactory::GetInstance();
+  brave_shields::AdBlockCnameCacheFactory::GetInstance();
   brave_shields::AdBlockPrefServiceFactory::GetInstance();
   brave_shields::CookiePrefServiceFactory::GetInstance();
 #if BUILDFLAG(ENABLE_GREASELION)
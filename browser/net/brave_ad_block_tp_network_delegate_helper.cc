@@ -12,11 +12,17 @@
 
 #include "base/base64url.h"
 #include "base/feature_list.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/task/post_task.h"
 #include "brave/browser/brave_browser_process_impl.h"
+#include "brave/browser/brave_shields/ad_block_cname_cache_factory.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
 #include "brave/common/url_constants.h"
+#include "brave/components/brave_shields/browser/ad_block_cname_cache.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/browser/brave_shields_web_contents_observer.h"
@@ -26,6 +32,7 @@
 #include "chrome/browser/net/secure_dns_config.h"
 #include "chrome/browser/net/system_network_context_manager.h"
 #include "content/public/browser/browser_context.h"
+#include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/storage_partition.h"
@@ -60,25 +67,13 @@ content::WebContents* GetWebContents(int render_process_id,
 
 }  // namespace
 
+// Completes the ad-block decision for |ctx| given the |result| of matching its
+// request URL, re-checking against the CNAME-uncloaked URL when needed.
 void ShouldBlockAdOnTaskRunner(std::shared_ptr<BraveRequestInfo> ctx,
-                               base::Optional<std::string> canonical_name) {
-  bool did_match_rule = false;
-  bool did_match_exception = false;
-  bool did_match_important = false;
-  if (!ctx->initiator_url.is_valid()) {
-    return;
-  }
-  std::string source_host = ctx->initiator_url.host();
-
-  g_brave_browser_process->ad_block_service()->ShouldStartRequest(
-      ctx->request_url, ctx->resource_type, source_host, &did_match_rule,
-      &did_match_exception, &did_match_important, &ctx->mock_data_url);
-  if (did_match_important) {
-    ctx->blocked_by = kAdBlocked;
-    return;
-  }
-
-  if (canonical_name.has_value() &&
+                               base::Optional<std::string> canonical_name,
+                               brave_shields::AdBlockMatchResult* result) {
+  DCHECK(ctx->initiator_url.is_valid());
+  if (!result->did_match_important && canonical_name.has_value() &&
       ctx->request_url.host() != *canonical_name && *canonical_name != "") {
     GURL::Replacements replacements = GURL::Replacements();
     replacements.SetHost(
@@ -86,12 +81,14 @@ void ShouldBlockAdOnTaskRunner(std::shared_ptr<BraveRequestInfo> ctx,
         url::Component(0, static_cast<int>(canonical_name->length())));
     const GURL canonical_url = ctx->request_url.ReplaceComponents(replacements);
 
-    g_brave_browser_process->ad_block_service()->ShouldStartRequest(
-        canonical_url, ctx->resource_type, source_host, &did_match_rule,
-        &did_match_exception, &did_match_important, &ctx->mock_data_url);
+    g_brave_browser_process->ad_block_service()->MatchRequest(
+        brave_shields::AdBlockMatchRequest(canonical_url, ctx->resource_type,
+                                           ctx->initiator_url.host()),
+        result);
   }
 
-  if (did_match_important || (did_match_rule && !did_match_exception)) {
+  ctx->mock_data_url = result->mock_data_url;
+  if (result->ShouldBlock()) {
     ctx->blocked_by = kAdBlocked;
   }
 }
@@ -107,14 +104,101 @@ void OnShouldBlockAdResult(const ResponseCallback& next_callback,
   next_callback.Run();
 }
 
+// Coalesces ad-block checks that are issued from the UI thread while a
+// previous batch is still queued, so that a subresource-heavy page is matched
+// in a few task runner hops rather than one hop per request.
+class AdBlockRequestBatcher {
+ public:
+  static AdBlockRequestBatcher* GetInstance() {
+    static base::NoDestructor<AdBlockRequestBatcher> instance;
+    return instance.get();
+  }
+
+  // Matches |ctx| (and its |canonical_name|, if any) and then runs |on_done|
+  // on the UI thread.
+  void Add(scoped_refptr<base::SequencedTaskRunner> task_runner,
+           std::shared_ptr<BraveRequestInfo> ctx,
+           const base::Optional<std::string>& canonical_name,
+           base::OnceClosure on_done) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    bool needs_flush = false;
+    {
+      base::AutoLock lock(lock_);
+      needs_flush = pending_.empty();
+      pending_.push_back({ctx, canonical_name, std::move(on_done)});
+    }
+    if (needs_flush) {
+      task_runner->PostTask(
+          FROM_HERE, base::BindOnce(&AdBlockRequestBatcher::FlushOnTaskRunner,
+                                    base::Unretained(this)));
+    }
+  }
+
+ private:
+  friend class base::NoDestructor<AdBlockRequestBatcher>;
+
+  struct PendingRequest {
+    std::shared_ptr<BraveRequestInfo> ctx;
+    base::Optional<std::string> canonical_name;
+    base::OnceClosure on_done;
+  };
+
+  AdBlockRequestBatcher() = default;
+  ~AdBlockRequestBatcher() = default;
+
+  void FlushOnTaskRunner() {
+    std::vector<PendingRequest> batch;
+    {
+      base::AutoLock lock(lock_);
+      batch.swap(pending_);
+    }
+    UMA_HISTOGRAM_COUNTS_1000("Brave.Adblock.RequestBatchSize", batch.size());
+
+    std::vector<brave_shields::AdBlockMatchRequest> requests;
+    std::vector<PendingRequest*> matched;
+    requests.reserve(batch.size());
+    matched.reserve(batch.size());
+    for (auto& pending : batch) {
+      if (!pending.ctx->initiator_url.is_valid())
+        continue;
+      requests.emplace_back(pending.ctx->request_url,
+                            pending.ctx->resource_type,
+                            pending.ctx->initiator_url.host());
+      matched.push_back(&pending);
+    }
+
+    std::vector<brave_shields::AdBlockMatchResult> results =
+        g_brave_browser_process->ad_block_service()->MatchRequests(requests);
+    for (size_t i = 0; i < matched.size(); ++i) {
+      ShouldBlockAdOnTaskRunner(matched[i]->ctx, matched[i]->canonical_name,
+                                &results[i]);
+    }
+
+    base::PostTask(FROM_HERE, {content::BrowserThread::UI},
+                   base::BindOnce(&AdBlockRequestBatcher::OnBatchResult,
+                                  std::move(batch)));
+  }
+
+  static void OnBatchResult(std::vector<PendingRequest> batch) {
+    for (auto& pending : batch) {
+      std::move(pending.on_done).Run();
+    }
+  }
+
+  base::Lock lock_;
+  std::vector<PendingRequest> pending_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockRequestBatcher);
+};
+
 void ShouldBlockAdWithOptionalCname(
     scoped_refptr<base::SequencedTaskRunner> task_runner,
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx,
     const base::Optional<std::string> cname) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-  task_runner->PostTaskAndReply(
-      FROM_HERE, base::BindOnce(&ShouldBlockAdOnTaskRunner, ctx, cname),
+  AdBlockRequestBatcher::GetInstance()->Add(
+      task_runner, ctx, cname,
       base::BindOnce(&OnShouldBlockAdResult, next_callback, ctx));
 }
 
@@ -126,12 +210,9 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
 
  public:
   AdblockCnameResolveHostClient(
-      const ResponseCallback& next_callback,
-      scoped_refptr<base::SequencedTaskRunner> task_runner,
-      std::shared_ptr<BraveRequestInfo> ctx) {
-    cb_ = base::BindOnce(&ShouldBlockAdWithOptionalCname, task_runner,
-                         std::move(next_callback), ctx);
-
+      std::shared_ptr<BraveRequestInfo> ctx,
+      base::OnceCallback<void(base::Optional<std::string>)> cb)
+      : cb_(std::move(cb)) {
     auto* web_contents = GetWebContents(
         ctx->render_process_id, ctx->render_frame_id, ctx->frame_tree_node_id);
     if (!web_contents) {
@@ -201,6 +282,41 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
   }
 };
 
+void OnOriginalURLMatched(scoped_refptr<base::SequencedTaskRunner> task_runner,
+                          const ResponseCallback& next_callback,
+                          std::shared_ptr<BraveRequestInfo> ctx,
+                          const brave_shields::AdBlockCnameCache::Key& key) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // Nothing left to uncloak if the request is already blocked.
+  if (ctx->blocked_by == kAdBlocked) {
+    OnShouldBlockAdResult(next_callback, ctx);
+    return;
+  }
+
+  auto on_resolved = base::BindOnce(
+      [](scoped_refptr<base::SequencedTaskRunner> task_runner,
+         const ResponseCallback& next_callback,
+         std::shared_ptr<BraveRequestInfo> ctx,
+         base::Optional<std::string> cname) {
+        if (!cname.has_value() || cname->empty() ||
+            *cname == ctx->request_url.host()) {
+          OnShouldBlockAdResult(next_callback, ctx);
+          return;
+        }
+        ShouldBlockAdWithOptionalCname(task_runner, next_callback, ctx, cname);
+      },
+      task_runner, next_callback, ctx);
+
+  brave_shields::AdBlockCnameCache* cache =
+      brave_shields::AdBlockCnameCacheFactory::GetForBrowserContext(
+          ctx->browser_context);
+  if (cache->AddPendingResolution(key, std::move(on_resolved))) {
+    new AdblockCnameResolveHostClient(
+        ctx, base::BindOnce(&brave_shields::AdBlockCnameCache::OnResolved,
+                            cache->AsWeakPtr(), key));
+  }
+}
+
 void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
                                  std::shared_ptr<BraveRequestInfo> ctx) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
@@ -217,10 +333,37 @@ void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
   if (ctx->browser_context->IsTor()) {
     ShouldBlockAdWithOptionalCname(task_runner, std::move(next_callback), ctx,
                                    base::nullopt);
-  } else {
-    new AdblockCnameResolveHostClient(std::move(next_callback), task_runner,
-                                      ctx);
+    return;
   }
+
+  if (!base::FeatureList::IsEnabled(
+          ::brave_shields::features::kBraveAdblockCnameCache)) {
+    new AdblockCnameResolveHostClient(
+        ctx, base::BindOnce(&ShouldBlockAdWithOptionalCname, task_runner,
+                            next_callback, ctx));
+    return;
+  }
+
+  // Use a canonical name we already know about, if any. Otherwise match the
+  // original URL right away and only wait for DNS if it was not blocked.
+  const brave_shields::AdBlockCnameCache::Key key(ctx->network_isolation_key,
+                                                  ctx->request_url.host());
+  std::string canonical_name;
+  const bool cache_hit =
+      brave_shields::AdBlockCnameCacheFactory::GetForBrowserContext(
+          ctx->browser_context)
+          ->Get(key, &canonical_name);
+  UMA_HISTOGRAM_BOOLEAN("Brave.ShieldsCNAMEBlocking.CacheHit", cache_hit);
+  if (cache_hit) {
+    ShouldBlockAdWithOptionalCname(task_runner, next_callback, ctx,
+                                   canonical_name);
+    return;
+  }
+
+  AdBlockRequestBatcher::GetInstance()->Add(
+      task_runner, ctx, base::nullopt,
+      base::BindOnce(&OnOriginalURLMatched, task_runner, next_callback, ctx,
+                     key));
 }
 
 int OnBeforeURLRequest_AdBlockTPPreWork(const ResponseCallback& next_callback,
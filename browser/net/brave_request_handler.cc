@@ -9,8 +9,11 @@
 #include <utility>
 
 #include "base/feature_list.h"
+#include "base/metrics/histogram.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/strings/strcat.h"
 #include "base/task/post_task.h"
+#include "base/time/time.h"
 #include "brave/browser/net/brave_ad_block_tp_network_delegate_helper.h"
 #include "brave/browser/net/brave_common_static_redirect_network_delegate_helper.h"
 #include "brave/browser/net/brave_httpse_network_delegate_helper.h"
@@ -31,6 +34,7 @@
 #include "content/public/common/url_constants.h"
 #include "extensions/common/constants.h"
 #include "net/base/net_errors.h"
+#include "url/url_constants.h"
 
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
 #include "brave/browser/net/brave_referrals_network_delegate_helper.h"
@@ -46,13 +50,44 @@
 
 #if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
 #include "brave/browser/net/brave_translate_redirect_network_delegate_helper.h"
+#include "brave/common/translate_network_constants.h"
+#include "extensions/common/url_pattern.h"
 #endif
 
 #if BUILDFLAG(IPFS_ENABLED)
 #include "brave/browser/net/ipfs_redirect_network_delegate_helper.h"
 #include "brave/components/ipfs/features.h"
+#include "brave/components/ipfs/ipfs_constants.h"
 #endif
 
+namespace {
+
+// Looks a hook's histogram up once, rather than by name on every request as
+// base::UmaHistogramTimes() would.
+base::HistogramBase* GetHandlerHistogram(const std::string& name) {
+  return base::Histogram::FactoryTimeGet(
+      name, base::TimeDelta::FromMilliseconds(1),
+      base::TimeDelta::FromSeconds(10), 50,
+      base::HistogramBase::kUmaTargetedHistogramFlag);
+}
+
+#if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
+// Hosts of the translate URL patterns that
+// OnBeforeURLRequest_TranslateRedirectWork acts on.
+base::flat_set<std::string> GetTranslateRedirectHosts() {
+  base::flat_set<std::string> hosts;
+  for (const char* pattern :
+       {kTranslateElementMainJSPattern, kTranslateMainJSPattern,
+        kTranslateRequestPattern, kTranslateGen204Pattern,
+        kTranslateElementMainCSSPattern, kTranslateBrandingPNGPattern}) {
+    hosts.insert(URLPattern(URLPattern::SCHEME_HTTPS, pattern).host());
+  }
+  return hosts;
+}
+#endif
+
+}  // namespace
+
 static bool IsInternalScheme(std::shared_ptr<brave::BraveRequestInfo> ctx) {
   DCHECK(ctx);
   return ctx->request_url.SchemeIs(extensions::kExtensionScheme) ||
@@ -68,62 +103,173 @@ BraveRequestHandler::BraveRequestHandler() {
 
 BraveRequestHandler::~BraveRequestHandler() = default;
 
+BraveRequestHandler::Handler::Handler() = default;
+
+BraveRequestHandler::Handler::Handler(const Handler&) = default;
+
+BraveRequestHandler::Handler::Handler(Handler&&) = default;
+
+BraveRequestHandler::Handler::~Handler() = default;
+
+BraveRequestHandler::Handler& BraveRequestHandler::Handler::operator=(
+    const Handler&) = default;
+
+BraveRequestHandler::Handler& BraveRequestHandler::Handler::operator=(
+    Handler&&) = default;
+
+bool BraveRequestHandler::Handler::Matches(
+    const brave::BraveRequestInfo& ctx) const {
+  if (!schemes.empty() && !base::Contains(schemes, ctx.request_url.scheme())) {
+    return false;
+  }
+
+  if (!hosts.empty() && !base::Contains(hosts, ctx.request_url.host())) {
+    return false;
+  }
+
+  if (!resource_types.empty() &&
+      !base::Contains(resource_types, ctx.resource_type)) {
+    return false;
+  }
+
+  return true;
+}
+
+int BraveRequestHandler::Handler::Run(
+    const brave::ResponseCallback& next_callback,
+    std::shared_ptr<brave::BraveRequestInfo> ctx) const {
+  switch (event_type) {
+    case brave::kOnBeforeRequest:
+      return on_before_url_request.Run(next_callback, ctx);
+    case brave::kOnBeforeStartTransaction:
+      return on_before_start_transaction.Run(ctx->headers, next_callback, ctx);
+    case brave::kOnHeadersReceived:
+      return on_headers_received.Run(
+          ctx->original_response_headers, ctx->override_response_headers,
+          ctx->allowed_unsafe_redirect_url, next_callback, ctx);
+    default:
+      NOTREACHED();
+      return net::OK;
+  }
+}
+
+// static
+BraveRequestHandler::Handler BraveRequestHandler::MakeHandler(
+    const std::string& name,
+    brave::OnBeforeURLRequestCallback callback) {
+  Handler handler;
+  handler.event_type = brave::kOnBeforeRequest;
+  handler.histogram = GetHandlerHistogram(
+      base::StrCat({"Brave.RequestHandler.OnBeforeURLRequest.", name}));
+  handler.on_before_url_request = callback;
+  return handler;
+}
+
+// static
+BraveRequestHandler::Handler BraveRequestHandler::MakeHandler(
+    const std::string& name,
+    brave::OnBeforeStartTransactionCallback callback) {
+  Handler handler;
+  handler.event_type = brave::kOnBeforeStartTransaction;
+  handler.histogram = GetHandlerHistogram(
+      base::StrCat({"Brave.RequestHandler.OnBeforeStartTransaction.", name}));
+  handler.on_before_start_transaction = callback;
+  return handler;
+}
+
+// static
+BraveRequestHandler::Handler BraveRequestHandler::MakeHandler(
+    const std::string& name,
+    brave::OnHeadersReceivedCallback callback) {
+  Handler handler;
+  handler.event_type = brave::kOnHeadersReceived;
+  handler.histogram = GetHandlerHistogram(
+      base::StrCat({"Brave.RequestHandler.OnHeadersReceived.", name}));
+  handler.on_headers_received = callback;
+  return handler;
+}
+
 void BraveRequestHandler::SetupCallbacks() {
-  brave::OnBeforeURLRequestCallback callback =
-      base::Bind(brave::OnBeforeURLRequest_SiteHacksWork);
-  before_url_request_callbacks_.push_back(callback);
+  AddHandler(MakeHandler("SiteHacks",
+                         base::Bind(brave::OnBeforeURLRequest_SiteHacksWork)));
 
-  callback = base::Bind(brave::OnBeforeURLRequest_AdBlockTPPreWork);
-  before_url_request_callbacks_.push_back(callback);
+  AddHandler(MakeHandler(
+      "AdBlockTP", base::Bind(brave::OnBeforeURLRequest_AdBlockTPPreWork)));
 
-  callback = base::Bind(brave::OnBeforeURLRequest_HttpsePreFileWork);
-  before_url_request_callbacks_.push_back(callback);
+  Handler httpse_handler = MakeHandler(
+      "Httpse", base::Bind(brave::OnBeforeURLRequest_HttpsePreFileWork));
+  httpse_handler.schemes = {url::kHttpScheme, url::kHttpsScheme};
+  AddHandler(std::move(httpse_handler));
 
-  callback = base::Bind(brave::OnBeforeURLRequest_CommonStaticRedirectWork);
-  before_url_request_callbacks_.push_back(callback);
+  // All of the redirected URL patterns are HTTP or HTTPS.
+  Handler common_static_redirect_handler = MakeHandler(
+      "CommonStaticRedirect",
+      base::Bind(brave::OnBeforeURLRequest_CommonStaticRedirectWork));
+  common_static_redirect_handler.schemes = {url::kHttpScheme,
+                                            url::kHttpsScheme};
+  AddHandler(std::move(common_static_redirect_handler));
 
 #if BUILDFLAG(BRAVE_REWARDS_ENABLED)
-  callback = base::Bind(brave_rewards::OnBeforeURLRequest);
-  before_url_request_callbacks_.push_back(callback);
+  Handler rewards_handler =
+      MakeHandler("Rewards", base::Bind(brave_rewards::OnBeforeURLRequest));
+  rewards_handler.schemes = {url::kHttpScheme, url::kHttpsScheme};
+  AddHandler(std::move(rewards_handler));
 #endif
 
 #if BUILDFLAG(ENABLE_BRAVE_TRANSLATE_GO)
-  callback =
-      base::BindRepeating(brave::OnBeforeURLRequest_TranslateRedirectWork);
-  before_url_request_callbacks_.push_back(callback);
+  Handler translate_redirect_handler = MakeHandler(
+      "TranslateRedirect",
+      base::BindRepeating(brave::OnBeforeURLRequest_TranslateRedirectWork));
+  translate_redirect_handler.schemes = {url::kHttpsScheme};
+  translate_redirect_handler.hosts = GetTranslateRedirectHosts();
+  AddHandler(std::move(translate_redirect_handler));
 #endif
 
 #if BUILDFLAG(IPFS_ENABLED)
   if (base::FeatureList::IsEnabled(ipfs::features::kIpfsFeature)) {
-    callback = base::BindRepeating(ipfs::OnBeforeURLRequest_IPFSRedirectWork);
-    before_url_request_callbacks_.push_back(callback);
-    brave::OnHeadersReceivedCallback ipfs_headers_received_callback =
-        base::Bind(ipfs::OnHeadersReceived_IPFSRedirectWork);
-    headers_received_callbacks_.push_back(ipfs_headers_received_callback);
+    Handler ipfs_redirect_handler = MakeHandler(
+        "IPFSRedirect",
+        base::BindRepeating(ipfs::OnBeforeURLRequest_IPFSRedirectWork));
+    ipfs_redirect_handler.schemes = {ipfs::kIPFSScheme, ipfs::kIPNSScheme};
+    AddHandler(std::move(ipfs_redirect_handler));
+
+    AddHandler(MakeHandler(
+        "IPFSRedirect", base::Bind(ipfs::OnHeadersReceived_IPFSRedirectWork)));
   }
 #endif
 
-  brave::OnBeforeStartTransactionCallback start_transaction_callback =
-      base::Bind(brave::OnBeforeStartTransaction_SiteHacksWork);
-  before_start_transaction_callbacks_.push_back(start_transaction_callback);
+  AddHandler(MakeHandler(
+      "SiteHacks", base::Bind(brave::OnBeforeStartTransaction_SiteHacksWork)));
 
-  start_transaction_callback =
-      base::Bind(brave::OnBeforeStartTransaction_GlobalPrivacyControlWork);
-  before_start_transaction_callbacks_.push_back(start_transaction_callback);
+  AddHandler(MakeHandler(
+      "GlobalPrivacyControl",
+      base::Bind(brave::OnBeforeStartTransaction_GlobalPrivacyControlWork)));
 
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
-  start_transaction_callback =
-      base::Bind(brave::OnBeforeStartTransaction_ReferralsWork);
-  before_start_transaction_callbacks_.push_back(start_transaction_callback);
+  AddHandler(MakeHandler(
+      "Referrals", base::Bind(brave::OnBeforeStartTransaction_ReferralsWork)));
 #endif
 
 #if BUILDFLAG(ENABLE_BRAVE_WEBTORRENT)
-  brave::OnHeadersReceivedCallback headers_received_callback =
-      base::Bind(webtorrent::OnHeadersReceived_TorrentRedirectWork);
-  headers_received_callbacks_.push_back(headers_received_callback);
+  Handler torrent_redirect_handler = MakeHandler(
+      "TorrentRedirect",
+      base::Bind(webtorrent::OnHeadersReceived_TorrentRedirectWork));
+  torrent_redirect_handler.resource_types = {
+      blink::mojom::ResourceType::kMainFrame};
+  AddHandler(std::move(torrent_redirect_handler));
 #endif
 }
 
+void BraveRequestHandler::AddHandler(Handler handler) {
+  DCHECK_NE(brave::kUnknownEventType, handler.event_type);
+  dispatch_table_[handler.event_type].push_back(std::move(handler));
+}
+
+bool BraveRequestHandler::HasHandlers(
+    brave::BraveNetworkDelegateEventType event_type) const {
+  return base::Contains(dispatch_table_, event_type);
+}
+
 void BraveRequestHandler::InitPrefChangeRegistrar() {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
@@ -156,30 +302,26 @@ int BraveRequestHandler::OnBeforeURLRequest(
     std::shared_ptr<brave::BraveRequestInfo> ctx,
     net::CompletionOnceCallback callback,
     GURL* new_url) {
-  if (before_url_request_callbacks_.empty() || IsInternalScheme(ctx)) {
+  if (!HasHandlers(brave::kOnBeforeRequest) || IsInternalScheme(ctx)) {
     return net::OK;
   }
   SCOPED_UMA_HISTOGRAM_TIMER("Brave.OnBeforeURLRequest_Handler");
   ctx->new_url = new_url;
   ctx->event_type = brave::kOnBeforeRequest;
-  callbacks_[ctx->request_identifier] = std::move(callback);
-  RunNextCallback(ctx);
-  return net::ERR_IO_PENDING;
+  return RunHandlers(ctx, std::move(callback));
 }
 
 int BraveRequestHandler::OnBeforeStartTransaction(
     std::shared_ptr<brave::BraveRequestInfo> ctx,
     net::CompletionOnceCallback callback,
     net::HttpRequestHeaders* headers) {
-  if (before_start_transaction_callbacks_.empty() || IsInternalScheme(ctx)) {
+  if (!HasHandlers(brave::kOnBeforeStartTransaction) || IsInternalScheme(ctx)) {
     return net::OK;
   }
   ctx->event_type = brave::kOnBeforeStartTransaction;
   ctx->headers = headers;
   ctx->referral_headers_list = referral_headers_list_.get();
-  callbacks_[ctx->request_identifier] = std::move(callback);
-  RunNextCallback(ctx);
-  return net::ERR_IO_PENDING;
+  return RunHandlers(ctx, std::move(callback));
 }
 
 int BraveRequestHandler::OnHeadersReceived(
@@ -194,20 +336,18 @@ int BraveRequestHandler::OnHeadersReceived(
         original_response_headers, override_response_headers);
   }
 
-  if (headers_received_callbacks_.empty() &&
+  if (!HasHandlers(brave::kOnHeadersReceived) &&
       !ctx->request_url.SchemeIs(content::kChromeUIScheme)) {
     // Extension scheme not excluded since brave_webtorrent needs it.
     return net::OK;
   }
 
-  callbacks_[ctx->request_identifier] = std::move(callback);
   ctx->event_type = brave::kOnHeadersReceived;
   ctx->original_response_headers = original_response_headers;
   ctx->override_response_headers = override_response_headers;
   ctx->allowed_unsafe_redirect_url = allowed_unsafe_redirect_url;
 
-  RunNextCallback(ctx);
-  return net::ERR_IO_PENDING;
+  return RunHandlers(ctx, std::move(callback));
 }
 
 void BraveRequestHandler::OnURLRequestDestroyed(
@@ -228,8 +368,29 @@ void BraveRequestHandler::RunCallbackForRequestIdentifier(
                  base::BindOnce(std::move(it->second), rv));
 }
 
-// TODO(iefremov): Merge all callback containers into one and run only one loop
-// instead of many (issues/5574).
+int BraveRequestHandler::RunHandlers(
+    std::shared_ptr<brave::BraveRequestInfo> ctx,
+    net::CompletionOnceCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  callbacks_[ctx->request_identifier] = std::move(callback);
+
+  const int rv = RunRemainingHandlers(ctx);
+  if (rv == net::ERR_IO_PENDING) {
+    return rv;
+  }
+
+  if (rv == net::OK || rv == net::ERR_BLOCKED_BY_CLIENT) {
+    // Every handler completed synchronously, so the caller can continue or
+    // cancel the request without waiting for a posted task.
+    callbacks_.erase(ctx->request_identifier);
+    return rv;
+  }
+
+  RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
+  return net::ERR_IO_PENDING;
+}
+
 void BraveRequestHandler::RunNextCallback(
     std::shared_ptr<brave::BraveRequestInfo> ctx) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
@@ -238,65 +399,48 @@ void BraveRequestHandler::RunNextCallback(
     return;
   }
 
-  // Continue processing callbacks until we hit one that returns PENDING
-  int rv = net::OK;
+  const int rv = RunRemainingHandlers(ctx);
+  if (rv == net::ERR_IO_PENDING) {
+    return;
+  }
 
-  if (ctx->event_type == brave::kOnBeforeRequest) {
-    while (before_url_request_callbacks_.size() !=
-           ctx->next_url_request_index) {
-      brave::OnBeforeURLRequestCallback callback =
-          before_url_request_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::Bind(&BraveRequestHandler::RunNextCallback,
-                     weak_factory_.GetWeakPtr(), ctx);
-      rv = callback.Run(next_callback, ctx);
-      if (rv == net::ERR_IO_PENDING) {
-        return;
-      }
-      if (rv != net::OK) {
-        break;
-      }
-    }
-  } else if (ctx->event_type == brave::kOnBeforeStartTransaction) {
-    while (before_start_transaction_callbacks_.size() !=
-           ctx->next_url_request_index) {
-      brave::OnBeforeStartTransactionCallback callback =
-          before_start_transaction_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::Bind(&BraveRequestHandler::RunNextCallback,
-                     weak_factory_.GetWeakPtr(), ctx);
-      rv = callback.Run(ctx->headers, next_callback, ctx);
-      if (rv == net::ERR_IO_PENDING) {
-        return;
-      }
-      if (rv != net::OK) {
-        break;
+  RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
+}
+
+int BraveRequestHandler::RunRemainingHandlers(
+    std::shared_ptr<brave::BraveRequestInfo> ctx) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+
+  const auto iter = dispatch_table_.find(ctx->event_type);
+  if (iter != dispatch_table_.end()) {
+    const std::vector<Handler>& handlers = iter->second;
+
+    // Only bound if a handler matches, and then shared by all of them.
+    brave::ResponseCallback next_callback;
+
+    // Continue processing handlers until we hit one that returns PENDING
+    while (handlers.size() != ctx->next_url_request_index) {
+      const Handler& handler = handlers[ctx->next_url_request_index++];
+      if (!handler.Matches(*ctx)) {
+        continue;
       }
-    }
-  } else if (ctx->event_type == brave::kOnHeadersReceived) {
-    while (headers_received_callbacks_.size() != ctx->next_url_request_index) {
-      brave::OnHeadersReceivedCallback callback =
-          headers_received_callbacks_[ctx->next_url_request_index++];
-      brave::ResponseCallback next_callback =
-          base::Bind(&BraveRequestHandler::RunNextCallback,
-                     weak_factory_.GetWeakPtr(), ctx);
-      rv = callback.Run(ctx->original_response_headers,
-                        ctx->override_response_headers,
-                        ctx->allowed_unsafe_redirect_url, next_callback, ctx);
-      if (rv == net::ERR_IO_PENDING) {
-        return;
+
+      if (!next_callback) {
+        next_callback = base::Bind(&BraveRequestHandler::RunNextCallback,
+                                   weak_factory_.GetWeakPtr(), ctx);
       }
+
+      const base::TimeTicks start_time = base::TimeTicks::Now();
+      const int rv = handler.Run(next_callback, ctx);
+      handler.histogram->AddTimeMillisecondsGranularity(
+          base::TimeTicks::Now() - start_time);
+
       if (rv != net::OK) {
-        break;
+        return rv;
       }
     }
   }
 
-  if (rv != net::OK) {
-    RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
-    return;
-  }
-
   if (ctx->event_type == brave::kOnBeforeRequest) {
     if (!ctx->new_url_spec.empty() &&
         (ctx->new_url_spec != ctx->request_url.spec()) &&
@@ -306,11 +450,10 @@ void BraveRequestHandler::RunNextCallback(
     if (ctx->blocked_by == brave::kAdBlocked ||
         ctx->blocked_by == brave::kOtherBlocked) {
       if (!ctx->ShouldMockRequest()) {
-        RunCallbackForRequestIdentifier(ctx->request_identifier,
-                                        net::ERR_BLOCKED_BY_CLIENT);
-        return;
+        return net::ERR_BLOCKED_BY_CLIENT;
       }
     }
   }
-  RunCallbackForRequestIdentifier(ctx->request_identifier, rv);
+
+  return net::OK;
 }
@@ -11,12 +11,18 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/flat_map.h"
+#include "base/containers/flat_set.h"
 #include "brave/browser/net/url_context.h"
 #include "content/public/browser/browser_thread.h"
 #include "net/base/completion_once_callback.h"
 
 class PrefChangeRegistrar;
 
+namespace base {
+class HistogramBase;
+}
+
 // Contains different network stack hooks (similar to capabilities of WebRequest
 // API).
 class BraveRequestHandler {
@@ -46,18 +52,70 @@ class BraveRequestHandler {
   void RunCallbackForRequestIdentifier(uint64_t request_identifier, int rv);
 
  private:
+  friend class BraveRequestHandlerTest;
+
+  // A network stack hook together with cheap static conditions on the requests
+  // it can act on. Requests which do not match are not passed to the hook.
+  struct Handler {
+    Handler();
+    Handler(const Handler&);
+    Handler(Handler&&);
+    ~Handler();
+
+    Handler& operator=(const Handler&);
+    Handler& operator=(Handler&&);
+
+    bool Matches(const brave::BraveRequestInfo& ctx) const;
+
+    int Run(const brave::ResponseCallback& next_callback,
+            std::shared_ptr<brave::BraveRequestInfo> ctx) const;
+
+    brave::BraveNetworkDelegateEventType event_type = brave::kUnknownEventType;
+
+    // Records how long the hook runs on the UI thread, excluding any
+    // asynchronous work it starts.
+    base::HistogramBase* histogram = nullptr;
+
+    // Each of these is ignored if it is empty.
+    base::flat_set<std::string> schemes;
+    base::flat_set<std::string> hosts;
+    base::flat_set<blink::mojom::ResourceType> resource_types;
+
+    // Only the callback for |event_type| is set.
+    brave::OnBeforeURLRequestCallback on_before_url_request;
+    brave::OnBeforeStartTransactionCallback on_before_start_transaction;
+    brave::OnHeadersReceivedCallback on_headers_received;
+  };
+
+  static Handler MakeHandler(const std::string& name,
+                             brave::OnBeforeURLRequestCallback callback);
+  static Handler MakeHandler(const std::string& name,
+                             brave::OnBeforeStartTransactionCallback callback);
+  static Handler MakeHandler(const std::string& name,
+                             brave::OnHeadersReceivedCallback callback);
+
   void SetupCallbacks();
+  void AddHandler(Handler handler);
+  bool HasHandlers(brave::BraveNetworkDelegateEventType event_type) const;
   void InitPrefChangeRegistrar();
   void OnReferralHeadersChanged();
   void OnPreferenceChanged(const std::string& pref_name);
   void UpdateAdBlockFromPref(const std::string& pref_name);
 
+  // Runs the handlers for |ctx->event_type| and returns the result of the
+  // request's callback if they all complete synchronously.
+  int RunHandlers(std::shared_ptr<brave::BraveRequestInfo> ctx,
+                  net::CompletionOnceCallback callback);
+
+  // Continues with the next handler once an asynchronous handler completes.
   void RunNextCallback(std::shared_ptr<brave::BraveRequestInfo> ctx);
 
-  std::vector<brave::OnBeforeURLRequestCallback> before_url_request_callbacks_;
-  std::vector<brave::OnBeforeStartTransactionCallback>
-      before_start_transaction_callbacks_;
-  std::vector<brave::OnHeadersReceivedCallback> headers_received_callbacks_;
+  // Returns net::ERR_IO_PENDING if a handler is still running asynchronously.
+  int RunRemainingHandlers(std::shared_ptr<brave::BraveRequestInfo> ctx);
+
+  // Handlers in the order they run, for each event type.
+  base::flat_map<brave::BraveNetworkDelegateEventType, std::vector<Handler>>
+      dispatch_table_;
 
   // TODO(iefremov): actually, we don't have to keep the list here, since
   // it is global for the whole browser and could live a singletonce in the
@@ -0,0 +1,150 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_request_handler.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/bind.h"
+#include "brave/browser/net/url_context.h"
+#include "chrome/test/base/scoped_testing_local_state.h"
+#include "chrome/test/base/testing_browser_process.h"
+#include "content/public/test/browser_task_environment.h"
+#include "net/base/net_errors.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/url_constants.h"
+
+using brave::BraveRequestInfo;
+using brave::ResponseCallback;
+
+namespace {
+
+int RunSynchronously(const ResponseCallback& next_callback,
+                     std::shared_ptr<BraveRequestInfo> ctx) {
+  return net::OK;
+}
+
+int RunAsynchronously(const ResponseCallback& next_callback,
+                      std::shared_ptr<BraveRequestInfo> ctx) {
+  return net::ERR_IO_PENDING;
+}
+
+int FailIfRun(const ResponseCallback& next_callback,
+              std::shared_ptr<BraveRequestInfo> ctx) {
+  ADD_FAILURE() << "Handler ran for " << ctx->request_url;
+  return net::OK;
+}
+
+}  // namespace
+
+class BraveRequestHandlerTest : public testing::Test {
+ public:
+  BraveRequestHandlerTest()
+      : local_state_(TestingBrowserProcess::GetGlobal()),
+        request_handler_(std::make_unique<BraveRequestHandler>()) {
+    // Only run the handlers added by the test.
+    request_handler_->dispatch_table_.clear();
+  }
+  ~BraveRequestHandlerTest() override = default;
+
+ protected:
+  using Handler = BraveRequestHandler::Handler;
+
+  static Handler MakeHandler(brave::OnBeforeURLRequestCallback callback) {
+    return BraveRequestHandler::MakeHandler("Test", std::move(callback));
+  }
+
+  void AddHandler(Handler handler) {
+    request_handler_->AddHandler(std::move(handler));
+  }
+
+  BraveRequestHandler* request_handler() { return request_handler_.get(); }
+
+ private:
+  content::BrowserTaskEnvironment task_environment_;
+  ScopedTestingLocalState local_state_;
+  std::unique_ptr<BraveRequestHandler> request_handler_;
+};
+
+TEST_F(BraveRequestHandlerTest, HandlerWithoutConditionsMatchesAnyRequest) {
+  const Handler handler = MakeHandler(base::BindRepeating(RunSynchronously));
+
+  EXPECT_TRUE(handler.Matches(BraveRequestInfo(GURL("https://brave.com/"))));
+  EXPECT_TRUE(handler.Matches(BraveRequestInfo(GURL("ipfs://bafy/"))));
+}
+
+TEST_F(BraveRequestHandlerTest, HandlerMatchesSchemes) {
+  Handler handler = MakeHandler(base::BindRepeating(RunSynchronously));
+  handler.schemes = {url::kHttpScheme, url::kHttpsScheme};
+
+  EXPECT_TRUE(handler.Matches(BraveRequestInfo(GURL("http://brave.com/"))));
+  EXPECT_TRUE(handler.Matches(BraveRequestInfo(GURL("https://brave.com/"))));
+  EXPECT_FALSE(handler.Matches(BraveRequestInfo(GURL("ftp://brave.com/"))));
+}
+
+TEST_F(BraveRequestHandlerTest, HandlerMatchesHosts) {
+  Handler handler = MakeHandler(base::BindRepeating(RunSynchronously));
+  handler.hosts = {"brave.com"};
+
+  EXPECT_TRUE(handler.Matches(BraveRequestInfo(GURL("https://brave.com/a"))));
+  EXPECT_FALSE(
+      handler.Matches(BraveRequestInfo(GURL("https://www.brave.com/a"))));
+  EXPECT_FALSE(handler.Matches(BraveRequestInfo(GURL("https://example.com/"))));
+}
+
+TEST_F(BraveRequestHandlerTest, HandlerMatchesResourceTypes) {
+  Handler handler = MakeHandler(base::BindRepeating(RunSynchronously));
+  handler.resource_types = {blink::mojom::ResourceType::kMainFrame};
+
+  BraveRequestInfo ctx(GURL("https://brave.com/"));
+  ctx.resource_type = blink::mojom::ResourceType::kMainFrame;
+  EXPECT_TRUE(handler.Matches(ctx));
+
+  ctx.resource_type = blink::mojom::ResourceType::kImage;
+  EXPECT_FALSE(handler.Matches(ctx));
+}
+
+TEST_F(BraveRequestHandlerTest, ReturnsOkWhenHandlersCompleteSynchronously) {
+  AddHandler(MakeHandler(base::BindRepeating(RunSynchronously)));
+
+  auto ctx = std::make_shared<BraveRequestInfo>(GURL("https://brave.com/"));
+  ctx->request_identifier = 1;
+  GURL new_url;
+  const int rv = request_handler()->OnBeforeURLRequest(
+      ctx, base::BindOnce([](int rv) { ADD_FAILURE(); }), &new_url);
+
+  EXPECT_EQ(net::OK, rv);
+  EXPECT_FALSE(request_handler()->IsRequestIdentifierValid(1));
+}
+
+TEST_F(BraveRequestHandlerTest, DoesNotRunHandlersThatDoNotMatch) {
+  Handler handler = MakeHandler(base::BindRepeating(FailIfRun));
+  handler.hosts = {"example.com"};
+  AddHandler(std::move(handler));
+  AddHandler(MakeHandler(base::BindRepeating(RunSynchronously)));
+
+  auto ctx = std::make_shared<BraveRequestInfo>(GURL("https://brave.com/"));
+  ctx->request_identifier = 1;
+  GURL new_url;
+  const int rv = request_handler()->OnBeforeURLRequest(
+      ctx, base::BindOnce([](int rv) { ADD_FAILURE(); }), &new_url);
+
+  EXPECT_EQ(net::OK, rv);
+}
+
+TEST_F(BraveRequestHandlerTest, ReturnsPendingWhileAHandlerRunsAsynchronously) {
+  AddHandler(MakeHandler(base::BindRepeating(RunAsynchronously)));
+
+  auto ctx = std::make_shared<BraveRequestInfo>(GURL("https://brave.com/"));
+  ctx->request_identifier = 1;
+  GURL new_url;
+  const int rv = request_handler()->OnBeforeURLRequest(
+      ctx, base::BindOnce([](int rv) {}), &new_url);
+
+  EXPECT_EQ(net::ERR_IO_PENDING, rv);
+  EXPECT_TRUE(request_handler()->IsRequestIdentifierValid(1));
+}
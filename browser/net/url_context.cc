@@ -29,14 +29,18 @@
 
 namespace brave {
 
-namespace {
+BraveRequestInfo::BraveRequestInfo() = default;
+
+BraveRequestInfo::BraveRequestInfo(const GURL& url) : request_url(url) {}
 
-std::string GetUploadData(const network::ResourceRequest& request) {
+BraveRequestInfo::~BraveRequestInfo() = default;
+
+std::string BraveRequestInfo::GetUploadData() const {
   std::string upload_data;
-  if (!request.request_body) {
-    return {};
+  if (!request_body) {
+    return upload_data;
   }
-  const auto* elements = request.request_body->elements();
+  const auto* elements = request_body->elements();
   for (const network::DataElement& element : *elements) {
     if (element.type() == network::mojom::DataElementDataView::Tag::kBytes) {
       const auto& bytes = element.As<network::DataElementBytes>().bytes();
@@ -47,14 +51,6 @@ std::string GetUploadData(const network::ResourceRequest& request) {
   return upload_data;
 }
 
-}  // namespace
-
-BraveRequestInfo::BraveRequestInfo() = default;
-
-BraveRequestInfo::BraveRequestInfo(const GURL& url) : request_url(url) {}
-
-BraveRequestInfo::~BraveRequestInfo() = default;
-
 // static
 std::shared_ptr<brave::BraveRequestInfo> BraveRequestInfo::MakeCTX(
     const network::ResourceRequest& request,
@@ -151,7 +147,7 @@ std::shared_ptr<brave::BraveRequestInfo> BraveRequestInfo::MakeCTX(
   ctx->allow_referrers = brave_shields::AllowReferrers(
       map,
       ctx->redirect_source.is_empty() ? ctx->tab_origin : ctx->redirect_source);
-  ctx->upload_data = GetUploadData(request);
+  ctx->request_body = request.request_body;
 
   ctx->browser_context = browser_context;
 
@@ -14,6 +14,7 @@
 #include "net/http/http_request_headers.h"
 #include "net/http/http_response_headers.h"
 #include "net/url_request/referrer_policy.h"
+#include "services/network/public/cpp/resource_request_body.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 #include "url/gurl.h"
 
@@ -113,7 +114,13 @@ struct BraveRequestInfo {
       static_cast<blink::mojom::ResourceType>(-1);
   blink::mojom::ResourceType resource_type = kInvalidResourceType;
 
-  std::string upload_data;
+  // The body of the request, which is shared with the request rather than
+  // copied. Use |GetUploadData| to read it.
+  scoped_refptr<network::ResourceRequestBody> request_body;
+
+  // Returns the bytes of |request_body|. They are copied on each call, so only
+  // call this once a handler knows that it needs them.
+  std::string GetUploadData() const;
 
   static std::shared_ptr<brave::BraveRequestInfo> MakeCTX(
       const network::ResourceRequest& request,
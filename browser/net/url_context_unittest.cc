@@ -0,0 +1,34 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/url_context.h"
+
+#include <string>
+
+#include "services/network/public/cpp/resource_request_body.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave {
+
+TEST(BraveRequestInfoTest, GetUploadDataWithoutRequestBody) {
+  BraveRequestInfo ctx(GURL("https://brave.com"));
+
+  EXPECT_TRUE(ctx.GetUploadData().empty());
+}
+
+TEST(BraveRequestInfoTest, GetUploadDataConcatenatesBytes) {
+  BraveRequestInfo ctx(GURL("https://brave.com"));
+
+  const std::string first = "foo=1&";
+  const std::string second = "bar=2";
+  ctx.request_body = base::MakeRefCounted<network::ResourceRequestBody>();
+  ctx.request_body->AppendBytes(first.data(), first.size());
+  ctx.request_body->AppendBytes(second.data(), second.size());
+
+  EXPECT_EQ("foo=1&bar=2", ctx.GetUploadData());
+}
+
+}  // namespace brave
@@ -23,6 +23,7 @@
 #include "components/prefs/pref_service.h"
 #include "net/base/features.h"
 
+using brave_shields::features::kBraveAdblockCnameCache;
 using brave_shields::features::kBraveAdblockCosmeticFiltering;
 using brave_shields::features::kBraveAdblockCosmeticFilteringNative;
 using brave_shields::features::kBraveDomainBlock;
@@ -132,6 +133,10 @@ using ntp_background_images::features::kBraveNTPSuperReferralWallpaper;
      flag_descriptions::kBraveAdblockCosmeticFilteringNativeDescription,   \
      kOsMac | kOsWin | kOsLinux,                                           \
      FEATURE_VALUE_TYPE(kBraveAdblockCosmeticFilteringNative)},            \
+    {"brave-adblock-cname-cache",                                          \
+     flag_descriptions::kBraveAdblockCnameCacheName,                       \
+     flag_descriptions::kBraveAdblockCnameCacheDescription, kOsAll,        \
+     FEATURE_VALUE_TYPE(kBraveAdblockCnameCache)},                         \
     {"brave-domain-block",                                                 \
      flag_descriptions::kBraveDomainBlockName,                             \
      flag_descriptions::kBraveDomainBlockDescription, kOsAll,              \
@@ -28,6 +28,10 @@ const char kBraveAdblockCosmeticFilteringNativeName[] =
     "Use native implementation for cosmetic filtering";
 const char kBraveAdblockCosmeticFilteringNativeDescription[] =
     "Uses native implementation for cosmetic filtering instead of extension";
+const char kBraveAdblockCnameCacheName[] = "Enable adblock CNAME cache";
+const char kBraveAdblockCnameCacheDescription[] =
+    "Reuses previously resolved canonical names for adblock CNAME uncloaking "
+    "and avoids waiting for DNS when a request is already blocked";
 const char kBraveDomainBlockName[] = "Enable domain blocking";
 const char kBraveDomainBlockDescription[] =
     "Enable support for blocking domains with an interstitial page";
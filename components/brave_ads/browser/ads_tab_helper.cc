@@ -8,6 +8,8 @@
 #include <memory>
 #include <utility>
 
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
 #include "brave/components/brave_ads/browser/ads_service.h"
 #include "brave/components/brave_ads/browser/ads_service_factory.h"
 #include "chrome/browser/profiles/profile.h"
@@ -28,6 +30,51 @@
 
 namespace brave_ads {
 
+namespace {
+
+// Text classification only looks at the first 1 MiB of a page, so never send
+// more than that to the ads service.
+constexpr size_t kMaximumTextLength = 1 << 20;
+
+// Conversions only need the verifiable conversion id meta tags, so collect
+// those instead of serializing the whole document.
+constexpr char kConversionHtmlScript[] = R"(
+    Array.from(document.querySelectorAll('meta[name="ad-conversion-id"]'),
+        (element) => element.outerHTML).join('\n')
+)";
+
+// Walks the text nodes of the page and stops as soon as |kMaximumTextLength|
+// characters have been collected, rather than laying out the whole document
+// for |innerText|.
+constexpr char kTextScriptTemplate[] = R"(
+    (function() {
+      const kMaximumLength = $1;
+      if (!document.body) {
+        return '';
+      }
+      const kIgnoredParents = new Set(['SCRIPT', 'STYLE', 'NOSCRIPT']);
+      const walker = document.createTreeWalker(document.body,
+          NodeFilter.SHOW_TEXT, {
+            acceptNode: (node) => kIgnoredParents.has(node.parentNode.nodeName)
+                ? NodeFilter.FILTER_REJECT : NodeFilter.FILTER_ACCEPT
+          });
+      const chunks = [];
+      let length = 0;
+      while (length < kMaximumLength && walker.nextNode()) {
+        const text = walker.currentNode.nodeValue.trim();
+        if (!text) {
+          continue;
+        }
+        const chunk = text.substring(0, kMaximumLength - length);
+        chunks.push(chunk);
+        length += chunk.length + 1;
+      }
+      return chunks.join(' ');
+    })()
+)";
+
+}  // namespace
+
 AdsTabHelper::AdsTabHelper(content::WebContents* web_contents)
     : WebContentsObserver(web_contents),
       tab_id_(sessions::SessionTabHelper::IdForTab(web_contents)),
@@ -79,12 +126,15 @@ void AdsTabHelper::RunIsolatedJavaScript(
   DCHECK(render_frame_host);
 
   dom_distiller::RunIsolatedJavaScript(
-      render_frame_host, "new XMLSerializer().serializeToString(document)",
+      render_frame_host, kConversionHtmlScript,
       base::BindOnce(&AdsTabHelper::OnJavaScriptHtmlResult,
                      weak_factory_.GetWeakPtr()));
 
   dom_distiller::RunIsolatedJavaScript(
-      render_frame_host, "document.body.innerText",
+      render_frame_host,
+      base::ReplaceStringPlaceholders(
+          kTextScriptTemplate, {base::NumberToString(kMaximumTextLength)},
+          nullptr),
       base::BindOnce(&AdsTabHelper::OnJavaScriptTextResult,
                      weak_factory_.GetWeakPtr()));
 }
@@ -93,8 +143,7 @@ void AdsTabHelper::OnJavaScriptHtmlResult(base::Value value) {
   DCHECK(ads_service_ && ads_service_->IsEnabled());
 
   DCHECK(value.is_string());
-  std::string html;
-  value.GetAsString(&html);
+  const std::string html = std::move(value.GetString());
 
   ads_service_->OnHtmlLoaded(tab_id_, redirect_chain_, html);
 }
@@ -104,7 +153,7 @@ void AdsTabHelper::OnJavaScriptTextResult(base::Value value) {
 
   DCHECK(value.is_string());
   std::string text;
-  value.GetAsString(&text);
+  base::TruncateUTF8ToByteSize(value.GetString(), kMaximumTextLength, &text);
 
   ads_service_->OnTextLoaded(tab_id_, redirect_chain_, text);
 }
@@ -6,6 +6,7 @@
 #include "brave/components/brave_shields/browser/ad_block_base_service.h"
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -15,92 +16,21 @@
 #include "base/json/json_reader.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
+#include "base/sequenced_task_runner.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/post_task.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_match_cache.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_task_traits.h"
 #include "content/public/browser/browser_thread.h"
-#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
-#include "url/origin.h"
 
 using brave_component_updater::BraveComponent;
 using content::BrowserThread;
-using namespace net::registry_controlled_domains;  // NOLINT
-
-namespace {
-
-std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
-  std::string filter_option = "";
-  switch (resource_type) {
-    // top level page
-    case blink::mojom::ResourceType::kMainFrame:
-      filter_option = "main_frame";
-      break;
-    // frame or iframe
-    case blink::mojom::ResourceType::kSubFrame:
-      filter_option = "sub_frame";
-      break;
-    // a CSS stylesheet
-    case blink::mojom::ResourceType::kStylesheet:
-      filter_option = "stylesheet";
-      break;
-    // an external script
-    case blink::mojom::ResourceType::kScript:
-      filter_option = "script";
-      break;
-    // an image (jpg/gif/png/etc)
-    case blink::mojom::ResourceType::kFavicon:
-    case blink::mojom::ResourceType::kImage:
-      filter_option = "image";
-      break;
-    // a font
-    case blink::mojom::ResourceType::kFontResource:
-      filter_option = "font";
-      break;
-    // an "other" subresource.
-    case blink::mojom::ResourceType::kSubResource:
-      filter_option = "other";
-      break;
-    // an object (or embed) tag for a plugin.
-    case blink::mojom::ResourceType::kObject:
-      filter_option = "object";
-      break;
-    // a media resource.
-    case blink::mojom::ResourceType::kMedia:
-      filter_option = "media";
-      break;
-    // a XMLHttpRequest
-    case blink::mojom::ResourceType::kXhr:
-      filter_option = "xhr";
-      break;
-    // a ping request for <a ping>/sendBeacon.
-    case blink::mojom::ResourceType::kPing:
-      filter_option = "ping";
-      break;
-    // the main resource of a dedicated worker.
-    case blink::mojom::ResourceType::kWorker:
-    // the main resource of a shared worker.
-    case blink::mojom::ResourceType::kSharedWorker:
-    // an explicitly requested prefetch
-    case blink::mojom::ResourceType::kPrefetch:
-    // the main resource of a service worker.
-    case blink::mojom::ResourceType::kServiceWorker:
-    // a report of Content Security Policy violations.
-    case blink::mojom::ResourceType::kCspReport:
-    // a resource that a plugin requested.
-    case blink::mojom::ResourceType::kPluginResource:
-    default:
-      break;
-  }
-  return filter_option;
-}
-
-}  // namespace
 
 namespace brave_shields {
 
@@ -121,24 +51,44 @@ void AdBlockBaseService::ShouldStartRequest(
     bool* did_match_exception,
     bool* did_match_important,
     std::string* mock_data_url) {
-  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  AdBlockMatchResult result;
+  result.did_match_rule = did_match_rule && *did_match_rule;
+  result.did_match_exception = did_match_exception && *did_match_exception;
+  result.did_match_important = did_match_important && *did_match_important;
+  if (mock_data_url)
+    result.mock_data_url = *mock_data_url;
+
+  MatchRequest(AdBlockMatchRequest(url, resource_type, tab_host), &result);
+
+  if (did_match_rule)
+    *did_match_rule = result.did_match_rule;
+  if (did_match_exception)
+    *did_match_exception = result.did_match_exception;
+  if (did_match_important)
+    *did_match_important = result.did_match_important;
+  if (mock_data_url)
+    *mock_data_url = std::move(result.mock_data_url);
+}
 
-  // Determine third-party here so the library doesn't need to figure it out.
-  // CreateFromNormalizedTuple is needed because SameDomainOrHost needs
-  // a URL or origin and not a string to a host name.
-  bool is_third_party = !SameDomainOrHost(
-      url,
-      url::Origin::CreateFromNormalizedTuple("https", tab_host.c_str(), 80),
-      INCLUDE_PRIVATE_REGISTRIES);
+void AdBlockBaseService::MatchRequest(const AdBlockMatchRequest& request,
+                                      AdBlockMatchResult* result) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  DCHECK(result);
   ad_block_client_->matches(
-      url.spec(), url.host(), tab_host, is_third_party,
-      ResourceTypeToString(resource_type), did_match_rule,
-      did_match_exception, did_match_important, mock_data_url);
+      request.url, request.host, request.tab_host, request.is_third_party,
+      request.resource_type_option, &result->did_match_rule,
+      &result->did_match_exception, &result->did_match_important,
+      &result->mock_data_url);
+}
 
-  // LOG(ERROR) << "AdBlockBaseService::ShouldStartRequest(), host: "
-  //  << tab_host
-  //  << ", resource type: " << resource_type
-  //  << ", url.spec(): " << url.spec();
+std::vector<AdBlockMatchResult> AdBlockBaseService::MatchRequests(
+    const std::vector<AdBlockMatchRequest>& requests) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  std::vector<AdBlockMatchResult> results(requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    MatchRequest(requests[i], &results[i]);
+  }
+  return results;
 }
 
 void AdBlockBaseService::EnableTag(const std::string& tag, bool enabled) {
@@ -149,17 +99,19 @@ void AdBlockBaseService::EnableTag(const std::string& tag, bool enabled) {
     return;
   }
 
+  std::vector<std::string>::iterator it =
+      std::find(tags_.begin(), tags_.end(), tag);
+  if (enabled == (it != tags_.end())) {
+    return;
+  }
   if (enabled) {
     ad_block_client_->addTag(tag);
     tags_.push_back(tag);
   } else {
     ad_block_client_->removeTag(tag);
-    std::vector<std::string>::iterator it =
-        std::find(tags_.begin(), tags_.end(), tag);
-    if (it != tags_.end()) {
-      tags_.erase(it);
-    }
+    tags_.erase(it);
   }
+  IncrementAdBlockEngineGeneration();
 }
 
 void AdBlockBaseService::AddResources(const std::string& resources) {
@@ -172,6 +124,7 @@ void AdBlockBaseService::AddResources(const std::string& resources) {
 
   ad_block_client_->addResources(resources);
   resources_ = resources;
+  IncrementAdBlockEngineGeneration();
 }
 
 bool AdBlockBaseService::TagExists(const std::string& tag) {
@@ -193,6 +146,26 @@ base::Optional<base::Value> AdBlockBaseService::HiddenClassIdSelectors(
       ad_block_client_->hiddenClassIdSelectors(classes, ids, exceptions));
 }
 
+bool AdBlockBaseService::MergeUrlCosmeticResourcesInto(
+    const std::string& url,
+    bool force_hide,
+    AdBlockCosmeticResources* resources) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  const std::string json = ad_block_client_->urlCosmeticResources(url);
+  return MergeCosmeticResourcesJSONInto(json, force_hide, resources);
+}
+
+bool AdBlockBaseService::MergeHiddenClassIdSelectorsInto(
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    const std::vector<std::string>& exceptions,
+    std::vector<std::string>* selectors) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  const std::string json =
+      ad_block_client_->hiddenClassIdSelectors(classes, ids, exceptions);
+  return MergeSelectorsJSONInto(json, selectors);
+}
+
 void AdBlockBaseService::GetDATFileData(const base::FilePath& dat_file_path) {
   base::PostTaskAndReplyWithResult(
       FROM_HERE, {base::ThreadPool(), base::MayBlock()},
@@ -221,17 +194,20 @@ void AdBlockBaseService::UpdateAdBlockClient(
     std::unique_ptr<adblock::Engine> ad_block_client) {
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
   ad_block_client_ = std::move(ad_block_client);
-  AddKnownTagsToAdBlockInstance();
-  AddKnownResourcesToAdBlockInstance();
+  OnAdBlockClientReplaced();
 }
 
-void AdBlockBaseService::AddKnownTagsToAdBlockInstance() {
-  std::for_each(tags_.begin(), tags_.end(),
-                [&](const std::string tag) { ad_block_client_->addTag(tag); });
+void AdBlockBaseService::ResetAdBlockClient(const std::string& rules) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  ad_block_client_.reset(new adblock::Engine(rules));
+  OnAdBlockClientReplaced();
 }
 
-void AdBlockBaseService::AddKnownResourcesToAdBlockInstance() {
+void AdBlockBaseService::OnAdBlockClientReplaced() {
+  std::for_each(tags_.begin(), tags_.end(),
+                [&](const std::string tag) { ad_block_client_->addTag(tag); });
   ad_block_client_->addResources(resources_);
+  IncrementAdBlockEngineGeneration();
 }
 
 bool AdBlockBaseService::Init() {
@@ -244,11 +220,10 @@ void AdBlockBaseService::ResetForTest(const std::string& rules,
   // filter rules to an existing instance. At which point the hack below
   // will dissapear.
   ad_block_client_.reset(new adblock::Engine(rules));
-  AddKnownTagsToAdBlockInstance();
   if (!resources.empty()) {
     resources_ = resources;
   }
-  AddKnownResourcesToAdBlockInstance();
+  OnAdBlockClientReplaced();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -17,8 +17,10 @@
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
 #include "base/values.h"
-#include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources.h"
+#include "brave/components/brave_shields/browser/ad_block_match_request.h"
+#include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 
 class AdBlockServiceTest;
@@ -47,6 +49,13 @@ class AdBlockBaseService : public BaseBraveShieldsService {
                           bool* did_match_exception,
                           bool* did_match_important,
                           std::string* mock_data_url) override;
+  // Matches |request| against this service's engine(s), accumulating into
+  // |result|. Must be called on the task runner.
+  virtual void MatchRequest(const AdBlockMatchRequest& request,
+                            AdBlockMatchResult* result);
+  // Matches a batch of requests in a single task runner hop.
+  std::vector<AdBlockMatchResult> MatchRequests(
+      const std::vector<AdBlockMatchRequest>& requests);
   void AddResources(const std::string& resources);
   void EnableTag(const std::string& tag, bool enabled);
   bool TagExists(const std::string& tag);
@@ -57,24 +66,40 @@ class AdBlockBaseService : public BaseBraveShieldsService {
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions);
+  // Typed variants of the above which merge this engine's results into
+  // |resources| / |selectors| without building intermediate Value trees.
+  // Return false if the engine produced no usable result.
+  bool MergeUrlCosmeticResourcesInto(const std::string& url,
+                                     bool force_hide,
+                                     AdBlockCosmeticResources* resources);
+  bool MergeHiddenClassIdSelectorsInto(
+      const std::vector<std::string>& classes,
+      const std::vector<std::string>& ids,
+      const std::vector<std::string>& exceptions,
+      std::vector<std::string>* selectors);
 
  protected:
   friend class ::AdBlockServiceTest;
   bool Init() override;
 
   void GetDATFileData(const base::FilePath& dat_file_path);
-  void AddKnownTagsToAdBlockInstance();
-  void AddKnownResourcesToAdBlockInstance();
+  // Replaces the engine with one built from |rules|. Must be called on the
+  // task runner.
+  void ResetAdBlockClient(const std::string& rules);
   void ResetForTest(const std::string& rules, const std::string& resources);
 
-  std::unique_ptr<adblock::Engine> ad_block_client_;
-
  private:
   void UpdateAdBlockClient(
       std::unique_ptr<adblock::Engine> ad_block_client);
   void OnGetDATFileData(GetDATFileDataResult result);
   void OnPreferenceChanges(const std::string& pref_name);
 
+  // Adds the known tags and resources to |ad_block_client_|, which has just
+  // been replaced, and invalidates cached match results.
+  void OnAdBlockClientReplaced();
+
+  // Only used on the task runner.
+  std::unique_ptr<adblock::Engine> ad_block_client_;
   std::vector<std::string> tags_;
   std::string resources_;
   base::WeakPtrFactory<AdBlockBaseService> weak_factory_;
@@ -0,0 +1,78 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_cname_cache.h"
+
+#include <utility>
+
+#include "content/public/browser/browser_thread.h"
+
+namespace brave_shields {
+
+namespace {
+
+const size_t kMaxCachedCanonicalNames = 1000;
+
+constexpr base::TimeDelta kCanonicalNameLifetime =
+    base::TimeDelta::FromMinutes(1);
+
+// Short enough that a host which failed to resolve because of a transient
+// network error is soon uncloaked again.
+constexpr base::TimeDelta kFailedResolutionLifetime =
+    base::TimeDelta::FromSeconds(10);
+
+}  // namespace
+
+AdBlockCnameCache::AdBlockCnameCache() : entries_(kMaxCachedCanonicalNames) {}
+
+AdBlockCnameCache::~AdBlockCnameCache() = default;
+
+bool AdBlockCnameCache::Get(const Key& key, std::string* canonical_name) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto it = entries_.Get(key);
+  if (it == entries_.end())
+    return false;
+  if (base::TimeTicks::Now() >= it->second.expires_at) {
+    entries_.Erase(it);
+    return false;
+  }
+  *canonical_name = it->second.canonical_name;
+  return true;
+}
+
+bool AdBlockCnameCache::AddPendingResolution(const Key& key,
+                                             ResolvedCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  auto& callbacks = pending_[key];
+  callbacks.push_back(std::move(callback));
+  return callbacks.size() == 1;
+}
+
+void AdBlockCnameCache::OnResolved(const Key& key,
+                                   base::Optional<std::string> canonical_name) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  if (canonical_name.has_value() && !canonical_name->empty()) {
+    entries_.Put(key,
+                 {*canonical_name, base::TimeTicks::Now() +
+                                       kCanonicalNameLifetime});
+  } else {
+    entries_.Put(key, {std::string(),
+                       base::TimeTicks::Now() + kFailedResolutionLifetime});
+  }
+
+  auto it = pending_.find(key);
+  if (it == pending_.end())
+    return;
+  std::vector<ResolvedCallback> callbacks = std::move(it->second);
+  pending_.erase(it);
+  for (auto& callback : callbacks)
+    std::move(callback).Run(canonical_name);
+}
+
+base::WeakPtr<AdBlockCnameCache> AdBlockCnameCache::AsWeakPtr() {
+  return weak_factory_.GetWeakPtr();
+}
+
+}  // namespace brave_shields
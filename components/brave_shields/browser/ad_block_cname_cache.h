@@ -0,0 +1,70 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_CNAME_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_CNAME_CACHE_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/optional.h"
+#include "base/time/time.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "net/base/network_isolation_key.h"
+
+namespace brave_shields {
+
+// Remembers the canonical names of hosts resolved for CNAME uncloaking, per
+// network isolation key, and coalesces concurrent resolutions of the same
+// host so that only one DNS lookup is in flight for it at a time. Failed
+// resolutions are remembered for a shorter time, so that an unresolvable
+// host is not looked up again for each of its requests. There is one
+// |AdBlockCnameCache| per profile; it lives on the UI thread.
+class AdBlockCnameCache : public KeyedService {
+ public:
+  using Key = std::pair<net::NetworkIsolationKey, std::string>;
+  using ResolvedCallback =
+      base::OnceCallback<void(base::Optional<std::string>)>;
+
+  AdBlockCnameCache();
+  ~AdBlockCnameCache() override;
+
+  // Returns true and sets |canonical_name| if |key| was resolved recently.
+  // |canonical_name| is empty if that resolution failed.
+  bool Get(const Key& key, std::string* canonical_name);
+
+  // Queues |callback| for the resolution of |key|. Returns true if the caller
+  // should start that resolution, i.e. none is in flight yet.
+  bool AddPendingResolution(const Key& key, ResolvedCallback callback);
+
+  // Caches the result of resolving |key| and runs its pending callbacks.
+  // |canonical_name| is empty if the resolution failed.
+  void OnResolved(const Key& key, base::Optional<std::string> canonical_name);
+
+  base::WeakPtr<AdBlockCnameCache> AsWeakPtr();
+
+ private:
+  struct Entry {
+    std::string canonical_name;
+    base::TimeTicks expires_at;
+  };
+
+  base::MRUCache<Key, Entry> entries_;
+  std::map<Key, std::vector<ResolvedCallback>> pending_;
+
+  base::WeakPtrFactory<AdBlockCnameCache> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockCnameCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_CNAME_CACHE_H_
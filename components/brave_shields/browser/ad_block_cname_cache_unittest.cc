@@ -0,0 +1,63 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_cname_cache.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+class AdBlockCnameCacheTest : public testing::Test {
+ public:
+  AdBlockCnameCacheTest()
+      : task_environment_(base::test::TaskEnvironment::TimeSource::MOCK_TIME) {}
+  ~AdBlockCnameCacheTest() override = default;
+
+ protected:
+  content::BrowserTaskEnvironment task_environment_;
+  AdBlockCnameCache cache_;
+};
+
+TEST_F(AdBlockCnameCacheTest, CoalescesPendingResolutions) {
+  const AdBlockCnameCache::Key key(net::NetworkIsolationKey(), "ads.example");
+  int resolved = 0;
+  auto on_resolved = [](int* resolved, base::Optional<std::string> name) {
+    EXPECT_EQ("tracker.example", name.value_or(std::string()));
+    ++*resolved;
+  };
+
+  EXPECT_TRUE(cache_.AddPendingResolution(
+      key, base::BindOnce(on_resolved, &resolved)));
+  EXPECT_FALSE(cache_.AddPendingResolution(
+      key, base::BindOnce(on_resolved, &resolved)));
+
+  cache_.OnResolved(key, std::string("tracker.example"));
+  EXPECT_EQ(2, resolved);
+
+  std::string canonical_name;
+  EXPECT_TRUE(cache_.Get(key, &canonical_name));
+  EXPECT_EQ("tracker.example", canonical_name);
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromMinutes(2));
+  EXPECT_FALSE(cache_.Get(key, &canonical_name));
+}
+
+TEST_F(AdBlockCnameCacheTest, CachesFailedResolutionsBriefly) {
+  const AdBlockCnameCache::Key key(net::NetworkIsolationKey(), "ads.example");
+  cache_.OnResolved(key, base::nullopt);
+
+  std::string canonical_name = "stale";
+  EXPECT_TRUE(cache_.Get(key, &canonical_name));
+  EXPECT_TRUE(canonical_name.empty());
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(30));
+  EXPECT_FALSE(cache_.Get(key, &canonical_name));
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,96 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources.h"
+
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/optional.h"
+#include "base/values.h"
+
+namespace brave_shields {
+
+namespace {
+
+// Moves the strings out of |list| into |into|, skipping anything else.
+void AppendStrings(base::Value* list, std::vector<std::string>* into) {
+  if (!list || !list->is_list())
+    return;
+
+  base::Value::ListView items = list->GetList();
+  into->reserve(into->size() + items.size());
+  for (base::Value& item : items) {
+    if (item.is_string())
+      into->push_back(std::move(item.GetString()));
+  }
+}
+
+}  // namespace
+
+AdBlockCosmeticResources::AdBlockCosmeticResources() = default;
+
+AdBlockCosmeticResources::AdBlockCosmeticResources(
+    AdBlockCosmeticResources&& other) = default;
+
+AdBlockCosmeticResources& AdBlockCosmeticResources::operator=(
+    AdBlockCosmeticResources&& other) = default;
+
+AdBlockCosmeticResources::~AdBlockCosmeticResources() = default;
+
+AdBlockHiddenSelectors::AdBlockHiddenSelectors() = default;
+
+AdBlockHiddenSelectors::AdBlockHiddenSelectors(
+    AdBlockHiddenSelectors&& other) = default;
+
+AdBlockHiddenSelectors& AdBlockHiddenSelectors::operator=(
+    AdBlockHiddenSelectors&& other) = default;
+
+AdBlockHiddenSelectors::~AdBlockHiddenSelectors() = default;
+
+bool MergeCosmeticResourcesJSONInto(const std::string& json,
+                                    bool force_hide,
+                                    AdBlockCosmeticResources* into) {
+  base::Optional<base::Value> from = base::JSONReader::Read(json);
+  if (!from || !from->is_dict())
+    return false;
+
+  AppendStrings(from->FindListKey("hide_selectors"),
+                force_hide ? &into->force_hide_selectors
+                           : &into->hide_selectors);
+
+  base::Value* style_selectors = from->FindDictKey("style_selectors");
+  if (style_selectors) {
+    for (auto item : style_selectors->DictItems()) {
+      AppendStrings(&item.second, &into->style_selectors[item.first]);
+    }
+  }
+
+  AppendStrings(from->FindListKey("exceptions"), &into->exceptions);
+
+  const std::string* injected_script = from->FindStringKey("injected_script");
+  if (injected_script && !injected_script->empty()) {
+    if (!into->injected_script.empty())
+      into->injected_script.push_back('\n');
+    into->injected_script.append(*injected_script);
+  }
+
+  if (from->FindBoolKey("generichide").value_or(false))
+    into->generichide = true;
+
+  return true;
+}
+
+bool MergeSelectorsJSONInto(const std::string& json,
+                            std::vector<std::string>* into) {
+  base::Optional<base::Value> from = base::JSONReader::Read(json);
+  if (!from || !from->is_list())
+    return false;
+
+  AppendStrings(&*from, into);
+  return true;
+}
+
+}  // namespace brave_shields
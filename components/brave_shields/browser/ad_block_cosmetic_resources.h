@@ -0,0 +1,68 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_COSMETIC_RESOURCES_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_COSMETIC_RESOURCES_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_map.h"
+
+namespace brave_shields {
+
+// Url-specific cosmetic filtering resources, merged across the default,
+// regional and custom filter engines. The layout mirrors
+// cosmetic_filters.mojom.UrlCosmeticResources so it can be moved straight into
+// a mojo message.
+struct AdBlockCosmeticResources {
+  AdBlockCosmeticResources();
+  AdBlockCosmeticResources(AdBlockCosmeticResources&& other);
+  AdBlockCosmeticResources& operator=(AdBlockCosmeticResources&& other);
+  ~AdBlockCosmeticResources();
+
+  std::vector<std::string> hide_selectors;
+  // Selectors from custom filters, which also apply to first-party content.
+  std::vector<std::string> force_hide_selectors;
+  base::flat_map<std::string, std::vector<std::string>> style_selectors;
+  std::vector<std::string> exceptions;
+  std::string injected_script;
+  bool generichide = false;
+  // See GetAdBlockEngineGeneration().
+  uint64_t engine_generation = 0;
+};
+
+// Generic selectors matching a set of classes and ids.
+struct AdBlockHiddenSelectors {
+  AdBlockHiddenSelectors();
+  AdBlockHiddenSelectors(AdBlockHiddenSelectors&& other);
+  AdBlockHiddenSelectors& operator=(AdBlockHiddenSelectors&& other);
+  ~AdBlockHiddenSelectors();
+
+  std::vector<std::string> hide_selectors;
+  // Selectors from custom filters, which also apply to first-party content.
+  std::vector<std::string> force_hide_selectors;
+  // See GetAdBlockEngineGeneration().
+  uint64_t engine_generation = 0;
+};
+
+// Merges the UrlCosmeticResources JSON returned by a single adblock-rust
+// engine into |into|. If |force_hide| is true, hide selectors are added to
+// |force_hide_selectors| instead. Returns false if |json| is not a resources
+// object.
+bool MergeCosmeticResourcesJSONInto(const std::string& json,
+                                    bool force_hide,
+                                    AdBlockCosmeticResources* into);
+
+// Appends the selector list JSON returned by a single adblock-rust engine's
+// hiddenClassIdSelectors to |into|. Returns false if |json| is not a list.
+bool MergeSelectorsJSONInto(const std::string& json,
+                            std::vector<std::string>* into);
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_COSMETIC_RESOURCES_H_
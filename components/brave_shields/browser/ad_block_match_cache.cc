@@ -0,0 +1,67 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_match_cache.h"
+
+#include <atomic>
+
+#include "base/strings/string_number_conversions.h"
+
+namespace brave_shields {
+
+namespace {
+
+std::atomic<uint64_t> g_ad_block_engine_generation{0};
+
+}  // namespace
+
+uint64_t GetAdBlockEngineGeneration() {
+  return g_ad_block_engine_generation.load(std::memory_order_acquire);
+}
+
+void IncrementAdBlockEngineGeneration() {
+  g_ad_block_engine_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+AdBlockMatchCache::AdBlockMatchCache(size_t max_size) : entries_(max_size) {}
+
+AdBlockMatchCache::~AdBlockMatchCache() = default;
+
+// static
+std::string AdBlockMatchCache::MakeKey(const AdBlockMatchRequest& request) {
+  std::string key;
+  key.reserve(request.tab_host.size() + request.url.size() + 8);
+  key.append(request.tab_host);
+  key.push_back(' ');
+  key.append(base::NumberToString(static_cast<int>(request.resource_type)));
+  key.push_back(' ');
+  key.append(request.url);
+  return key;
+}
+
+bool AdBlockMatchCache::Get(const AdBlockMatchRequest& request,
+                            uint64_t generation,
+                            AdBlockMatchResult* result) {
+  base::AutoLock lock(lock_);
+  auto it = entries_.Get(MakeKey(request));
+  if (it == entries_.end()) {
+    return false;
+  }
+  if (it->second.generation != generation) {
+    entries_.Erase(it);
+    return false;
+  }
+  *result = it->second.result;
+  return true;
+}
+
+void AdBlockMatchCache::Put(const AdBlockMatchRequest& request,
+                            uint64_t generation,
+                            const AdBlockMatchResult& result) {
+  base::AutoLock lock(lock_);
+  entries_.Put(MakeKey(request), {generation, result});
+}
+
+}  // namespace brave_shields
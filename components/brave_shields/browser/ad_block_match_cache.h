@@ -0,0 +1,58 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MATCH_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MATCH_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "brave/components/brave_shields/browser/ad_block_match_request.h"
+
+namespace brave_shields {
+
+// Returns the current generation of the ad-block engines. The generation is
+// bumped whenever any engine is replaced or mutated (list updates, tags,
+// resources, custom filters, regional list toggles), which implicitly
+// invalidates every cached decision stamped with an older generation.
+uint64_t GetAdBlockEngineGeneration();
+void IncrementAdBlockEngineGeneration();
+
+// A bounded, thread-safe cache of ad-block decisions keyed by request URL,
+// resource type and tab host. Entries are only returned if they were computed
+// against the current engine generation.
+class AdBlockMatchCache {
+ public:
+  explicit AdBlockMatchCache(size_t max_size = 1000);
+  ~AdBlockMatchCache();
+
+  bool Get(const AdBlockMatchRequest& request,
+           uint64_t generation,
+           AdBlockMatchResult* result);
+  void Put(const AdBlockMatchRequest& request,
+           uint64_t generation,
+           const AdBlockMatchResult& result);
+
+ private:
+  struct Entry {
+    uint64_t generation;
+    AdBlockMatchResult result;
+  };
+
+  static std::string MakeKey(const AdBlockMatchRequest& request);
+
+  base::Lock lock_;
+  base::HashingMRUCache<std::string, Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockMatchCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MATCH_CACHE_H_
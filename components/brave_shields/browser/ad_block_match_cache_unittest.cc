@@ -0,0 +1,55 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_match_cache.h"
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+TEST(AdBlockMatchCacheTest, HitsOnlyForSameRequestAndGeneration) {
+  AdBlockMatchCache cache(2);
+  const AdBlockMatchRequest script(GURL("https://ads.example/a.js"),
+                                   blink::mojom::ResourceType::kScript,
+                                   "brave.com");
+  const AdBlockMatchRequest image(GURL("https://ads.example/a.js"),
+                                  blink::mojom::ResourceType::kImage,
+                                  "brave.com");
+  AdBlockMatchResult blocked;
+  blocked.did_match_rule = true;
+
+  const uint64_t generation = GetAdBlockEngineGeneration();
+  cache.Put(script, generation, blocked);
+
+  AdBlockMatchResult result;
+  EXPECT_TRUE(cache.Get(script, generation, &result));
+  EXPECT_TRUE(result.ShouldBlock());
+  EXPECT_FALSE(cache.Get(image, generation, &result));
+
+  IncrementAdBlockEngineGeneration();
+  EXPECT_FALSE(cache.Get(script, GetAdBlockEngineGeneration(), &result));
+}
+
+TEST(AdBlockMatchCacheTest, EvictsLeastRecentlyUsed) {
+  AdBlockMatchCache cache(2);
+  const uint64_t generation = GetAdBlockEngineGeneration();
+  const AdBlockMatchRequest a(GURL("https://a.example/"),
+                              blink::mojom::ResourceType::kImage, "brave.com");
+  const AdBlockMatchRequest b(GURL("https://b.example/"),
+                              blink::mojom::ResourceType::kImage, "brave.com");
+  const AdBlockMatchRequest c(GURL("https://c.example/"),
+                              blink::mojom::ResourceType::kImage, "brave.com");
+  cache.Put(a, generation, AdBlockMatchResult());
+  cache.Put(b, generation, AdBlockMatchResult());
+
+  AdBlockMatchResult result;
+  EXPECT_TRUE(cache.Get(a, generation, &result));
+  cache.Put(c, generation, AdBlockMatchResult());
+  EXPECT_FALSE(cache.Get(b, generation, &result));
+  EXPECT_TRUE(cache.Get(a, generation, &result));
+  EXPECT_TRUE(cache.Get(c, generation, &result));
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,67 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MATCH_REQUEST_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MATCH_REQUEST_H_
+
+#include <string>
+
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+// Describes a single network request to be checked against the ad-block
+// engines. All of the strings handed to adblock-rust are computed once here,
+// so that the default, regional and custom filter engines can all be queried
+// without rebuilding them for every engine.
+struct AdBlockMatchRequest {
+  AdBlockMatchRequest(const GURL& url,
+                      blink::mojom::ResourceType resource_type,
+                      const std::string& tab_host);
+  AdBlockMatchRequest(const AdBlockMatchRequest& other);
+  AdBlockMatchRequest(AdBlockMatchRequest&& other);
+  AdBlockMatchRequest& operator=(const AdBlockMatchRequest& other);
+  AdBlockMatchRequest& operator=(AdBlockMatchRequest&& other);
+  ~AdBlockMatchRequest();
+
+  std::string url;
+  std::string host;
+  std::string tab_host;
+  bool is_third_party = false;
+  blink::mojom::ResourceType resource_type;
+  // The adblock-rust filter option for |resource_type|, e.g. "script".
+  std::string resource_type_option;
+};
+
+// The accumulated outcome of matching an |AdBlockMatchRequest|. Engines only
+// ever set flags, so a single result can be threaded through several engines.
+struct AdBlockMatchResult {
+  AdBlockMatchResult();
+  AdBlockMatchResult(const AdBlockMatchResult& other);
+  AdBlockMatchResult(AdBlockMatchResult&& other);
+  AdBlockMatchResult& operator=(const AdBlockMatchResult& other);
+  AdBlockMatchResult& operator=(AdBlockMatchResult&& other);
+  ~AdBlockMatchResult();
+
+  // Whether the request should be blocked given the flags below.
+  bool ShouldBlock() const {
+    return did_match_important || (did_match_rule && !did_match_exception);
+  }
+
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string mock_data_url;
+};
+
+// Returns the adblock-rust filter option for |resource_type|, or an empty
+// string when the type has no equivalent.
+const char* ResourceTypeToFilterOption(
+    blink::mojom::ResourceType resource_type);
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_MATCH_REQUEST_H_
@@ -5,16 +5,19 @@
 
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 
+#include <atomic>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#include "base/metrics/histogram_macros.h"
 #include "base/strings/string_util.h"
 #include "base/task/post_task.h"
 #include "base/values.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "brave/components/brave_shields/browser/ad_block_match_cache.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
@@ -30,12 +33,43 @@ namespace brave_shields {
 AdBlockRegionalServiceManager::AdBlockRegionalServiceManager(
     brave_component_updater::BraveComponent::Delegate* delegate)
     : delegate_(delegate),
-      initialized_(false) {
+      initialized_(false),
+      regional_services_(std::make_shared<RegionalServiceMap>()) {
 }
 
 AdBlockRegionalServiceManager::~AdBlockRegionalServiceManager() {
 }
 
+std::shared_ptr<const AdBlockRegionalServiceManager::RegionalServiceMap>
+AdBlockRegionalServiceManager::GetRegionalServices() const {
+  return std::atomic_load(&regional_services_);
+}
+
+void AdBlockRegionalServiceManager::PublishRegionalServices(
+    std::unique_ptr<RegionalServiceMap> services) {
+  regional_services_write_lock_.AssertAcquired();
+  std::atomic_store(
+      &regional_services_,
+      std::shared_ptr<const RegionalServiceMap>(std::move(services)));
+  IncrementAdBlockEngineGeneration();
+}
+
+std::shared_ptr<AdBlockRegionalService>
+AdBlockRegionalServiceManager::CreateRegionalService(
+    const adblock::FilterList& catalog_entry) {
+  // The last snapshot referencing a disabled service may be released on any
+  // sequence, but the service itself must go away on the UI thread where its
+  // component callbacks are bound.
+  auto regional_service = std::shared_ptr<AdBlockRegionalService>(
+      AdBlockRegionalServiceFactory(catalog_entry, delegate_).release(),
+      [](AdBlockRegionalService* service) {
+        content::BrowserThread::DeleteSoon(content::BrowserThread::UI,
+                                           FROM_HERE, service);
+      });
+  regional_service->Start();
+  return regional_service;
+}
+
 bool AdBlockRegionalServiceManager::Init() {
   DCHECK(!initialized_);
   base::PostTask(
@@ -69,7 +103,9 @@ void AdBlockRegionalServiceManager::StartRegionalServices() {
   }
 
   // Start all regional services associated with enabled filter lists
-  base::AutoLock lock(regional_services_lock_);
+  base::AutoLock lock(regional_services_write_lock_);
+  auto regional_services =
+      std::make_unique<RegionalServiceMap>(*GetRegionalServices());
   const base::DictionaryValue* regional_filters_dict =
       local_state->GetDictionary(kAdBlockRegionalFilters);
   for (base::DictionaryValue::Iterator it(*regional_filters_dict);
@@ -83,15 +119,14 @@ void AdBlockRegionalServiceManager::StartRegionalServices() {
     if (enabled) {
       auto catalog_entry = brave_shields::FindAdBlockFilterListByUUID(
           regional_catalog_, uuid);
-      if (catalog_entry != regional_catalog_.end()) {
-        auto regional_service = AdBlockRegionalServiceFactory(
-            *catalog_entry, delegate_);
-        regional_service->Start();
-        regional_services_.insert(
-            std::make_pair(uuid, std::move(regional_service)));
+      if (catalog_entry != regional_catalog_.end() &&
+          regional_services->find(uuid) == regional_services->end()) {
+        regional_services->insert(
+            std::make_pair(uuid, CreateRegionalService(*catalog_entry)));
       }
     }
   }
+  PublishRegionalServices(std::move(regional_services));
 
   initialized_ = true;
 }
@@ -115,46 +150,45 @@ bool AdBlockRegionalServiceManager::IsInitialized() const {
 }
 
 bool AdBlockRegionalServiceManager::Start() {
-  base::AutoLock lock(regional_services_lock_);
-  for (const auto& regional_service : regional_services_) {
+  auto regional_services = GetRegionalServices();
+  for (const auto& regional_service : *regional_services) {
     regional_service.second->Start();
   }
 
   return true;
 }
 
-void AdBlockRegionalServiceManager::ShouldStartRequest(
-    const GURL& url,
-    blink::mojom::ResourceType resource_type,
-    const std::string& tab_host,
-    bool* did_match_rule,
-    bool* did_match_exception,
-    bool* did_match_important,
-    std::string* mock_data_url) {
-  base::AutoLock lock(regional_services_lock_);
-
-  for (const auto& regional_service : regional_services_) {
-    regional_service.second->ShouldStartRequest(
-        url, resource_type, tab_host, did_match_rule, did_match_exception,
-        did_match_important, mock_data_url);
-    if (did_match_important && *did_match_important) {
-      return;
+void AdBlockRegionalServiceManager::MatchRequest(
+    const AdBlockMatchRequest& request,
+    AdBlockMatchResult* result) {
+  const base::TimeTicks start = base::TimeTicks::Now();
+  auto regional_services = GetRegionalServices();
+
+  for (const auto& regional_service : *regional_services) {
+    regional_service.second->MatchRequest(request, result);
+    if (result->did_match_important) {
+      break;
     }
   }
+
+  UMA_HISTOGRAM_CUSTOM_MICROSECONDS_TIMES(
+      "Brave.Adblock.RegionalMatchTime", base::TimeTicks::Now() - start,
+      base::TimeDelta::FromMicroseconds(1), base::TimeDelta::FromSeconds(1),
+      50);
 }
 
 void AdBlockRegionalServiceManager::EnableTag(const std::string& tag,
                                               bool enabled) {
-  base::AutoLock lock(regional_services_lock_);
-  for (const auto& regional_service : regional_services_) {
+  auto regional_services = GetRegionalServices();
+  for (const auto& regional_service : *regional_services) {
     regional_service.second->EnableTag(tag, enabled);
   }
 }
 
 void AdBlockRegionalServiceManager::AddResources(
     const std::string& resources) {
-  base::AutoLock lock(regional_services_lock_);
-  for (const auto& regional_service : regional_services_) {
+  auto regional_services = GetRegionalServices();
+  for (const auto& regional_service : *regional_services) {
     regional_service.second->AddResources(resources);
   }
 }
@@ -167,21 +201,21 @@ void AdBlockRegionalServiceManager::EnableFilterList(
 
   // Enable or disable the specified filter list
   if (initialized_) {
-    base::AutoLock lock(regional_services_lock_);
+    base::AutoLock lock(regional_services_write_lock_);
     DCHECK(catalog_entry != regional_catalog_.end());
-    auto it = regional_services_.find(uuid);
+    auto regional_services =
+        std::make_unique<RegionalServiceMap>(*GetRegionalServices());
+    auto it = regional_services->find(uuid);
     if (enabled) {
-      DCHECK(it == regional_services_.end());
-      auto regional_service = AdBlockRegionalServiceFactory(
-          *catalog_entry, delegate_);
-      regional_service->Start();
-      regional_services_.insert(
-          std::make_pair(uuid, std::move(regional_service)));
+      DCHECK(it == regional_services->end());
+      regional_services->insert(
+          std::make_pair(uuid, CreateRegionalService(*catalog_entry)));
     } else {
-      DCHECK(it != regional_services_.end());
+      DCHECK(it != regional_services->end());
       it->second->Unregister();
-      regional_services_.erase(it);
+      regional_services->erase(it);
     }
+    PublishRegionalServices(std::move(regional_services));
   }
 
   // Update preferences to reflect enabled/disabled state of specified
@@ -195,15 +229,15 @@ void AdBlockRegionalServiceManager::EnableFilterList(
 base::Optional<base::Value>
 AdBlockRegionalServiceManager::UrlCosmeticResources(
         const std::string& url) {
-  base::AutoLock lock(regional_services_lock_);
-  auto it = regional_services_.begin();
-  if (it == regional_services_.end()) {
+  auto regional_services = GetRegionalServices();
+  auto it = regional_services->begin();
+  if (it == regional_services->end()) {
     return base::Optional<base::Value>();
   }
   base::Optional<base::Value> first_value =
       it->second->UrlCosmeticResources(url);
 
-  for ( ; it != regional_services_.end(); it++) {
+  for ( ; it != regional_services->end(); it++) {
     base::Optional<base::Value> next_value =
         it->second->UrlCosmeticResources(url);
     if (first_value) {
@@ -223,15 +257,15 @@ AdBlockRegionalServiceManager::HiddenClassIdSelectors(
         const std::vector<std::string>& classes,
         const std::vector<std::string>& ids,
         const std::vector<std::string>& exceptions) {
-  base::AutoLock lock(regional_services_lock_);
-  auto it = regional_services_.begin();
-  if (it == regional_services_.end()) {
+  auto regional_services = GetRegionalServices();
+  auto it = regional_services->begin();
+  if (it == regional_services->end()) {
     return base::Optional<base::Value>();
   }
   base::Optional<base::Value> first_value =
       it->second->HiddenClassIdSelectors(classes, ids, exceptions);
 
-  for ( ; it != regional_services_.end(); it++) {
+  for ( ; it != regional_services->end(); it++) {
     base::Optional<base::Value> next_value =
         it->second->HiddenClassIdSelectors(classes, ids, exceptions);
     if (first_value && first_value->is_list()) {
@@ -250,10 +284,33 @@ AdBlockRegionalServiceManager::HiddenClassIdSelectors(
   return first_value;
 }
 
+void AdBlockRegionalServiceManager::MergeUrlCosmeticResourcesInto(
+    const std::string& url,
+    AdBlockCosmeticResources* resources) {
+  auto regional_services = GetRegionalServices();
+  for (const auto& regional_service : *regional_services) {
+    regional_service.second->MergeUrlCosmeticResourcesInto(
+        url, /*force_hide=*/false, resources);
+  }
+}
+
+void AdBlockRegionalServiceManager::MergeHiddenClassIdSelectorsInto(
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    const std::vector<std::string>& exceptions,
+    std::vector<std::string>* selectors) {
+  auto regional_services = GetRegionalServices();
+  for (const auto& regional_service : *regional_services) {
+    regional_service.second->MergeHiddenClassIdSelectorsInto(
+        classes, ids, exceptions, selectors);
+  }
+}
+
 void AdBlockRegionalServiceManager::SetRegionalCatalog(
         std::vector<adblock::FilterList> catalog) {
   regional_catalog_ = std::move(catalog);
-  for (const auto& regional_service : regional_services_) {
+  auto regional_services = GetRegionalServices();
+  for (const auto& regional_service : *regional_services) {
     auto catalog_entry = brave_shields::FindAdBlockFilterListByUUID(
         regional_catalog_, regional_service.second->GetUUID());
     if (catalog_entry != regional_catalog_.end()) {
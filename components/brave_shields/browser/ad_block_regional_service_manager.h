@@ -18,6 +18,8 @@
 #include "base/values.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/brave_component.h"
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources.h"
+#include "brave/components/brave_shields/browser/ad_block_match_request.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 #include "url/gurl.h"
 
@@ -47,13 +49,8 @@ class AdBlockRegionalServiceManager {
 
   bool IsInitialized() const;
   bool Start();
-  void ShouldStartRequest(const GURL& url,
-                          blink::mojom::ResourceType resource_type,
-                          const std::string& tab_host,
-                          bool* did_match_rule,
-                          bool* did_match_exception,
-                          bool* did_match_important,
-                          std::string* mock_data_url);
+  void MatchRequest(const AdBlockMatchRequest& request,
+                    AdBlockMatchResult* result);
   void EnableTag(const std::string& tag, bool enabled);
   void AddResources(const std::string& resources);
   void EnableFilterList(const std::string& uuid, bool enabled);
@@ -64,6 +61,13 @@ class AdBlockRegionalServiceManager {
           const std::vector<std::string>& classes,
           const std::vector<std::string>& ids,
           const std::vector<std::string>& exceptions);
+  void MergeUrlCosmeticResourcesInto(const std::string& url,
+                                     AdBlockCosmeticResources* resources);
+  void MergeHiddenClassIdSelectorsInto(
+      const std::vector<std::string>& classes,
+      const std::vector<std::string>& ids,
+      const std::vector<std::string>& exceptions,
+      std::vector<std::string>* selectors);
 
  private:
   friend class ::AdBlockServiceTest;
@@ -71,11 +75,23 @@ class AdBlockRegionalServiceManager {
   void StartRegionalServices();
   void UpdateFilterListPrefs(const std::string& uuid, bool enabled);
 
+  // Immutable set of enabled regional services, keyed by filter list UUID.
+  // A new map is published whenever a list is enabled or disabled, so that
+  // readers never block on (or are blocked by) list toggles.
+  using RegionalServiceMap =
+      std::map<std::string, std::shared_ptr<AdBlockRegionalService>>;
+
+  std::shared_ptr<const RegionalServiceMap> GetRegionalServices() const;
+  // Must be called with |regional_services_write_lock_| held.
+  void PublishRegionalServices(std::unique_ptr<RegionalServiceMap> services);
+  std::shared_ptr<AdBlockRegionalService> CreateRegionalService(
+      const adblock::FilterList& catalog_entry);
+
   brave_component_updater::BraveComponent::Delegate* delegate_;  // NOT OWNED
   bool initialized_;
-  base::Lock regional_services_lock_;
-  std::map<std::string, std::unique_ptr<AdBlockRegionalService>>
-      regional_services_;
+  // Serializes writers only; readers load |regional_services_| atomically.
+  base::Lock regional_services_write_lock_;
+  std::shared_ptr<const RegionalServiceMap> regional_services_;
 
   std::vector<adblock::FilterList> regional_catalog_;
 
@@ -15,6 +15,7 @@
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/thread_restrictions.h"
@@ -22,6 +23,7 @@
 #include "brave/common/pref_names.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_service.h"
+#include "brave/components/brave_shields/browser/ad_block_match_cache.h"
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
@@ -75,31 +77,39 @@ std::string AdBlockService::g_ad_block_component_id_(kAdBlockComponentId);
 std::string AdBlockService::g_ad_block_component_base64_public_key_(
     kAdBlockComponentBase64PublicKey);
 
-void AdBlockService::ShouldStartRequest(
-    const GURL& url,
-    blink::mojom::ResourceType resource_type,
-    const std::string& tab_host,
-    bool* did_match_rule,
-    bool* did_match_exception,
-    bool* did_match_important,
-    std::string* mock_data_url) {
-  AdBlockBaseService::ShouldStartRequest(
-      url, resource_type, tab_host, did_match_rule, did_match_exception,
-      did_match_important, mock_data_url);
-  if (did_match_important && *did_match_important) {
+void AdBlockService::MatchRequest(const AdBlockMatchRequest& request,
+                                  AdBlockMatchResult* result) {
+  // Decisions are cached for a fresh match and then merged into |result|,
+  // which may already carry flags from a previous (e.g. CNAME) check.
+  const uint64_t generation = GetAdBlockEngineGeneration();
+  AdBlockMatchResult request_result;
+  const bool hit = match_cache_.Get(request, generation, &request_result);
+  UMA_HISTOGRAM_BOOLEAN("Brave.Adblock.MatchCacheHit", hit);
+  if (!hit) {
+    MatchRequestUncached(request, &request_result);
+    match_cache_.Put(request, generation, request_result);
+  }
+
+  result->did_match_rule |= request_result.did_match_rule;
+  result->did_match_exception |= request_result.did_match_exception;
+  result->did_match_important |= request_result.did_match_important;
+  if (!request_result.mock_data_url.empty())
+    result->mock_data_url = std::move(request_result.mock_data_url);
+}
+
+void AdBlockService::MatchRequestUncached(const AdBlockMatchRequest& request,
+                                          AdBlockMatchResult* result) {
+  AdBlockBaseService::MatchRequest(request, result);
+  if (result->did_match_important) {
     return;
   }
 
-  regional_service_manager()->ShouldStartRequest(
-      url, resource_type, tab_host, did_match_rule, did_match_exception,
-      did_match_important, mock_data_url);
-  if (did_match_important && *did_match_important) {
+  regional_service_manager()->MatchRequest(request, result);
+  if (result->did_match_important) {
     return;
   }
 
-  custom_filters_service()->ShouldStartRequest(
-      url, resource_type, tab_host, did_match_rule, did_match_exception,
-      did_match_important, mock_data_url);
+  custom_filters_service()->MatchRequest(request, result);
 }
 
 base::Optional<base::Value> AdBlockService::UrlCosmeticResources(
@@ -180,6 +190,35 @@ base::Optional<base::Value> AdBlockService::HiddenClassIdSelectors(
   return hide_selectors;
 }
 
+base::Optional<AdBlockCosmeticResources> AdBlockService::GetCosmeticResources(
+    const std::string& url) {
+  AdBlockCosmeticResources resources;
+  resources.engine_generation = GetAdBlockEngineGeneration();
+  if (!MergeUrlCosmeticResourcesInto(url, /*force_hide=*/false, &resources))
+    return base::nullopt;
+
+  regional_service_manager()->MergeUrlCosmeticResourcesInto(url, &resources);
+  custom_filters_service()->MergeUrlCosmeticResourcesInto(
+      url, /*force_hide=*/true, &resources);
+
+  return resources;
+}
+
+AdBlockHiddenSelectors AdBlockService::GetHiddenClassIdSelectors(
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    const std::vector<std::string>& exceptions) {
+  AdBlockHiddenSelectors selectors;
+  selectors.engine_generation = GetAdBlockEngineGeneration();
+  MergeHiddenClassIdSelectorsInto(classes, ids, exceptions,
+                                  &selectors.hide_selectors);
+  regional_service_manager()->MergeHiddenClassIdSelectorsInto(
+      classes, ids, exceptions, &selectors.hide_selectors);
+  custom_filters_service()->MergeHiddenClassIdSelectorsInto(
+      classes, ids, exceptions, &selectors.force_hide_selectors);
+  return selectors;
+}
+
 AdBlockRegionalServiceManager* AdBlockService::regional_service_manager() {
   if (!regional_service_manager_)
     regional_service_manager_ =
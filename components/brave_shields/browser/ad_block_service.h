@@ -15,6 +15,7 @@
 #include "base/optional.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_base_service.h"
+#include "brave/components/brave_shields/browser/ad_block_match_cache.h"
 #include "components/keyed_service/core/keyed_service.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "content/public/browser/browser_thread.h"
@@ -49,13 +50,8 @@ class AdBlockService : public AdBlockBaseService {
   explicit AdBlockService(BraveComponent::Delegate* delegate);
   ~AdBlockService() override;
 
-  void ShouldStartRequest(const GURL& url,
-                          blink::mojom::ResourceType resource_type,
-                          const std::string& tab_host,
-                          bool* did_match_rule,
-                          bool* did_match_exception,
-                          bool* did_match_important,
-                          std::string* mock_data_url) override;
+  void MatchRequest(const AdBlockMatchRequest& request,
+                    AdBlockMatchResult* result) override;
   base::Optional<base::Value> UrlCosmeticResources(
       const std::string& url) override;
   base::Optional<base::Value> HiddenClassIdSelectors(
@@ -63,6 +59,16 @@ class AdBlockService : public AdBlockBaseService {
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions) override;
 
+  // Typed counterparts of UrlCosmeticResources and HiddenClassIdSelectors,
+  // used to answer the cosmetic filters renderer over mojo. Custom filter
+  // selectors are returned separately as force-hide selectors.
+  base::Optional<AdBlockCosmeticResources> GetCosmeticResources(
+      const std::string& url);
+  AdBlockHiddenSelectors GetHiddenClassIdSelectors(
+      const std::vector<std::string>& classes,
+      const std::vector<std::string>& ids,
+      const std::vector<std::string>& exceptions);
+
   AdBlockRegionalServiceManager* regional_service_manager();
   AdBlockCustomFiltersService* custom_filters_service();
 
@@ -84,6 +90,10 @@ class AdBlockService : public AdBlockBaseService {
       const std::string& component_id,
       const std::string& component_base64_public_key);
 
+  void MatchRequestUncached(const AdBlockMatchRequest& request,
+                            AdBlockMatchResult* result);
+
+  AdBlockMatchCache match_cache_;
   std::unique_ptr<brave_shields::AdBlockRegionalServiceManager>
       regional_service_manager_;
   std::unique_ptr<brave_shields::AdBlockCustomFiltersService>
@@ -28,3 +28,28 @@ TEST(HTTPSEverywhereRecentlyUsedCacheTest, Operations) {
   cache.remove("kD");
   ASSERT_FALSE(cache.get("kD", &v));
 }
+
+TEST(HTTPSEverywhereRecentlyUsedCacheTest, Sharded) {
+  using Cache = HTTPSERecentlyUsedCache<std::string>;
+  Cache cache(64, 4);
+
+  std::string v;
+  for (int i = 0; i < 16; ++i)
+    cache.add("k" + std::to_string(i), "v" + std::to_string(i));
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_TRUE(cache.get("k" + std::to_string(i), &v));
+    ASSERT_EQ("v" + std::to_string(i), v);
+  }
+
+  // Negative results are stored as empty values.
+  cache.add("example.com", std::string());
+  ASSERT_TRUE(cache.get("example.com", &v));
+  ASSERT_TRUE(v.empty());
+
+  cache.remove("k3");
+  ASSERT_FALSE(cache.get("k3", &v));
+
+  cache.clear();
+  ASSERT_FALSE(cache.get("k0", &v));
+  ASSERT_FALSE(cache.get("example.com", &v));
+}
@@ -0,0 +1,129 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_ruleset.h"
+
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/memory/ptr_util.h"
+#include "base/optional.h"
+#include "base/values.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace brave_shields {
+
+HTTPSEverywhereRuleset::Rule::Rule() = default;
+HTTPSEverywhereRuleset::Rule::Rule(Rule&& other) = default;
+HTTPSEverywhereRuleset::Rule::~Rule() = default;
+
+HTTPSEverywhereRuleset::Target::Target() = default;
+HTTPSEverywhereRuleset::Target::Target(Target&& other) = default;
+HTTPSEverywhereRuleset::Target::~Target() = default;
+
+HTTPSEverywhereRuleset::HTTPSEverywhereRuleset() = default;
+
+HTTPSEverywhereRuleset::~HTTPSEverywhereRuleset() = default;
+
+// static
+std::unique_ptr<HTTPSEverywhereRuleset> HTTPSEverywhereRuleset::FromJSON(
+    const std::string& json) {
+  base::Optional<base::Value> json_object = base::JSONReader::Read(json);
+  if (!json_object || !json_object->is_list()) {
+    return nullptr;
+  }
+
+  auto ruleset = base::WrapUnique(new HTTPSEverywhereRuleset());
+  for (const auto& target_value : json_object->GetList()) {
+    if (!target_value.is_dict()) {
+      continue;
+    }
+
+    Target target;
+    const base::Value* exclusions = target_value.FindListKey("e");
+    if (exclusions) {
+      for (const auto& exclusion : exclusions->GetList()) {
+        if (!exclusion.is_dict()) {
+          continue;
+        }
+        const std::string* pattern = exclusion.FindStringKey("p");
+        if (!pattern) {
+          continue;
+        }
+        target.exclusions.push_back(
+            std::make_unique<re2::RE2>(CorrectToRuleForRE2(*pattern)));
+      }
+    }
+
+    const base::Value* rules = target_value.FindListKey("r");
+    if (rules) {
+      target.has_rules = true;
+      for (const auto& rule_value : rules->GetList()) {
+        if (!rule_value.is_dict()) {
+          continue;
+        }
+        Rule rule;
+        if (rule_value.FindKey("d")) {
+          rule.default_rule = true;
+          target.rules.push_back(std::move(rule));
+          continue;
+        }
+        const std::string* from = rule_value.FindStringKey("f");
+        const std::string* to = rule_value.FindStringKey("t");
+        if (!from || !to) {
+          continue;
+        }
+        rule.from = std::make_unique<re2::RE2>(*from);
+        rule.to = CorrectToRuleForRE2(*to);
+        target.rules.push_back(std::move(rule));
+      }
+    }
+
+    ruleset->targets_.push_back(std::move(target));
+  }
+
+  return ruleset;
+}
+
+// static
+std::string HTTPSEverywhereRuleset::CorrectToRuleForRE2(const std::string& to) {
+  std::string corrected_to(to);
+  size_t pos = corrected_to.find("$");
+  while (std::string::npos != pos) {
+    corrected_to[pos] = '\\';
+    pos = corrected_to.find("$", pos + 1);
+  }
+
+  return corrected_to;
+}
+
+std::string HTTPSEverywhereRuleset::Apply(const std::string& url) const {
+  for (const auto& target : targets_) {
+    for (const auto& exclusion : target.exclusions) {
+      if (re2::RE2::FullMatch(url, *exclusion)) {
+        return "";
+      }
+    }
+
+    if (!target.has_rules) {
+      return "";
+    }
+
+    for (const auto& rule : target.rules) {
+      if (rule.default_rule) {
+        std::string new_url(url);
+        return new_url.insert(4, "s");
+      }
+
+      std::string new_url(url);
+      if (re2::RE2::Replace(&new_url, *rule.from, rule.to) && new_url != url) {
+        return new_url;
+      }
+    }
+  }
+  return "";
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULESET_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULESET_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace re2 {
+class RE2;
+}  // namespace re2
+
+namespace brave_shields {
+
+// The compiled form of one HTTPS Everywhere database entry. The JSON stored
+// in the database is parsed once and every exclusion and rewrite pattern is
+// compiled to an RE2 up front, so applying the ruleset to a URL only runs
+// prebuilt regular expressions.
+class HTTPSEverywhereRuleset {
+ public:
+  ~HTTPSEverywhereRuleset();
+
+  // Returns nullptr if |json| is not a valid ruleset list.
+  static std::unique_ptr<HTTPSEverywhereRuleset> FromJSON(
+      const std::string& json);
+
+  // Converts a rewrite target from the JavaScript "$1" syntax to RE2's "\1".
+  static std::string CorrectToRuleForRE2(const std::string& to);
+
+  // Returns the upgraded URL, or an empty string if no rule applies.
+  std::string Apply(const std::string& url) const;
+
+ private:
+  struct Rule {
+    Rule();
+    Rule(Rule&& other);
+    ~Rule();
+
+    // Rules marked with "d" just swap the scheme to https.
+    bool default_rule = false;
+    std::unique_ptr<re2::RE2> from;
+    std::string to;
+  };
+
+  struct Target {
+    Target();
+    Target(Target&& other);
+    ~Target();
+
+    std::vector<std::unique_ptr<re2::RE2>> exclusions;
+    // False if the entry had no (valid) "r" list, which ends evaluation.
+    bool has_rules = false;
+    std::vector<Rule> rules;
+  };
+
+  HTTPSEverywhereRuleset();
+
+  std::vector<Target> targets_;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSEverywhereRuleset);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULESET_H_
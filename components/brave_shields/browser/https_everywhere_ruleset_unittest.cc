@@ -0,0 +1,54 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_ruleset.h"
+
+#include <memory>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+TEST(HTTPSEverywhereRulesetTest, InvalidJSON) {
+  EXPECT_FALSE(HTTPSEverywhereRuleset::FromJSON("not json"));
+  EXPECT_FALSE(HTTPSEverywhereRuleset::FromJSON("{\"r\": []}"));
+}
+
+TEST(HTTPSEverywhereRulesetTest, DefaultRule) {
+  std::unique_ptr<HTTPSEverywhereRuleset> ruleset =
+      HTTPSEverywhereRuleset::FromJSON("[{\"r\": [{\"d\": 1}]}]");
+  ASSERT_TRUE(ruleset);
+  EXPECT_EQ("https://example.com/", ruleset->Apply("http://example.com/"));
+}
+
+TEST(HTTPSEverywhereRulesetTest, RewriteRule) {
+  std::unique_ptr<HTTPSEverywhereRuleset> ruleset =
+      HTTPSEverywhereRuleset::FromJSON(
+          "[{\"r\": [{\"f\": \"^http://(www\\\\.)?example\\\\.com/\","
+          " \"t\": \"https://$1example.com/\"}]}]");
+  ASSERT_TRUE(ruleset);
+  EXPECT_EQ("https://www.example.com/a",
+            ruleset->Apply("http://www.example.com/a"));
+  EXPECT_EQ("", ruleset->Apply("http://other.com/"));
+}
+
+TEST(HTTPSEverywhereRulesetTest, Exclusion) {
+  std::unique_ptr<HTTPSEverywhereRuleset> ruleset =
+      HTTPSEverywhereRuleset::FromJSON(
+          "[{\"e\": [{\"p\": \"^http://example\\\\.com/insecure.*\"}],"
+          " \"r\": [{\"d\": 1}]}]");
+  ASSERT_TRUE(ruleset);
+  EXPECT_EQ("", ruleset->Apply("http://example.com/insecure/page"));
+  EXPECT_EQ("https://example.com/page",
+            ruleset->Apply("http://example.com/page"));
+}
+
+TEST(HTTPSEverywhereRulesetTest, CorrectToRuleForRE2) {
+  EXPECT_EQ("https://\\1.example.com/\\2",
+            HTTPSEverywhereRuleset::CorrectToRuleForRE2(
+                "https://$1.example.com/$2"));
+}
+
+}  // namespace brave_shields
@@ -12,15 +12,15 @@
 
 #include "base/base_paths.h"
 #include "base/bind.h"
-#include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
-#include "base/values.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
-#include "third_party/re2/src/re2/re2.h"
 #include "third_party/zlib/google/zip.h"
 
 #define DAT_FILE "httpse.leveldb.zip"
@@ -30,41 +30,60 @@
 
 namespace {
 
-std::vector<std::string> Split(const std::string& s, char delim) {
-  std::stringstream ss(s);
-  std::string item;
-  std::vector<std::string> result;
-  while (getline(ss, item, delim)) {
-    result.push_back(item);
-  }
-  return result;
-}
+// Number of recently used database entries kept parsed. Each entry holds the
+// regular expressions of one lookup domain, compiled when it was first read.
+constexpr size_t kRecentlyUsedRulesetCacheSize = 500;
+
+// Size and lock striping of the result cache. Entries are either an upgraded
+// URL keyed by spec, or an empty value meaning "no upgrade" keyed by spec or,
+// when no database entry exists for any of its lookup domains, by host.
+constexpr size_t kResultCacheSize = 2000;
+constexpr size_t kResultCacheShardCount = 8;
+
+// These values are persisted to logs. Entries should not be renumbered and
+// numeric values should never be reused.
+enum class ResultCacheLookup {
+  kMiss = 0,
+  kHit = 1,
+  kNegativeUrlHit = 2,
+  kNegativeHostHit = 3,
+  kMaxValue = kNegativeHostHit,
+};
 
 // returns parts in reverse order, makes list of lookup domains like com.foo.*
 std::vector<std::string> ExpandDomainForLookup(const std::string& domain) {
   std::vector<std::string> resultDomains;
-  std::vector<std::string> domainParts = Split(domain, '.');
-  if (domainParts.empty()) {
+  std::vector<base::StringPiece> domainParts = base::SplitStringPiece(
+      domain, ".", base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+  if (!domainParts.empty() && domainParts.back().empty()) {
+    domainParts.pop_back();
+  }
+  if (domainParts.size() < 2) {
     return resultDomains;
   }
 
-  for (size_t i = 0; i < domainParts.size() - 1; i++) {
-    // i < size()-1 is correct: don't want 'com.*' added to resultDomains
-    std::string slice = "";
-    std::string dot = "";
-    for (int j = domainParts.size() - 1; j >= static_cast<int>(i); j--) {
-      slice += dot + domainParts[j];
-      dot = ".";
-    }
-    if (0 != i) {
-      // We don't want * on the top URL
-      resultDomains.push_back(slice + ".*");
-    } else {
-      resultDomains.push_back(slice);
+  // Build the fully reversed domain once; every lookup key is a prefix of it.
+  std::string reversed;
+  reversed.reserve(domain.size());
+  std::vector<size_t> prefixLengths(domainParts.size());
+  for (size_t j = domainParts.size(); j-- > 0;) {
+    if (!reversed.empty()) {
+      reversed.push_back('.');
     }
+    domainParts[j].AppendToString(&reversed);
+    prefixLengths[j] = reversed.size();
+  }
+
+  resultDomains.reserve(domainParts.size() - 1);
+  // i < size()-1 is correct: don't want 'com.*' added to resultDomains
+  resultDomains.push_back(reversed);
+  for (size_t i = 1; i < domainParts.size() - 1; i++) {
+    // We don't want * on the top URL
+    resultDomains.push_back(reversed.substr(0, prefixLengths[i]) + ".*");
   }
   return resultDomains;
 }
+
 std::string leveldbGet(leveldb::DB* db, const std::string &key) {
   if (!db) {
     return "";
@@ -100,6 +119,8 @@ HTTPSEverywhereService::g_https_everywhere_component_base64_public_key_(
 HTTPSEverywhereService::HTTPSEverywhereService(
     BraveComponent::Delegate* delegate)
     : BaseBraveShieldsService(delegate),
+      recently_used_cache_(kResultCacheSize, kResultCacheShardCount),
+      recently_used_rulesets_(kRecentlyUsedRulesetCacheSize),
       level_db_(nullptr) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
@@ -128,6 +149,8 @@ void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
   }
 
   CloseDatabase();
+  recently_used_rulesets_.Clear();
+  recently_used_cache_.clear();
 
   leveldb::Options options;
   leveldb::Status status =
@@ -170,7 +193,11 @@ bool HTTPSEverywhereService::GetHTTPSURL(
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), new_url)) {
+  // Requests reach this after a miss in |GetHTTPSURLFromCacheOnly|, which
+  // has already recorded the lookup.
+  if (GetCachedResult(*url, /*record_lookup=*/false, new_url)) {
+    if (new_url->empty())
+      return false;
     AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
@@ -184,10 +211,12 @@ bool HTTPSEverywhereService::GetHTTPSURL(
 
   const std::vector<std::string> domains =
       ExpandDomainForLookup(candidate_url.host());
-  for (auto domain : domains) {
-    std::string value = leveldbGet(level_db_, domain);
-    if (!value.empty()) {
-      *new_url = ApplyHTTPSRule(candidate_url.spec(), value);
+  bool has_rules = false;
+  for (const auto& domain : domains) {
+    const HTTPSEverywhereRuleset* ruleset = GetRuleset(domain);
+    if (ruleset) {
+      has_rules = true;
+      *new_url = ruleset->Apply(candidate_url.spec());
       if (0 != new_url->length()) {
         recently_used_cache_.add(candidate_url.spec(), *new_url);
         AddHTTPSEUrlToRedirectList(request_identifier);
@@ -195,7 +224,11 @@ bool HTTPSEverywhereService::GetHTTPSURL(
       }
     }
   }
-  recently_used_cache_.remove(candidate_url.spec());
+  new_url->clear();
+  // Without any database entry the result can't depend on the path, so a
+  // single negative entry covers every URL on the host.
+  recently_used_cache_.add(
+      has_rules ? candidate_url.spec() : candidate_url.host(), std::string());
   return false;
 }
 
@@ -213,11 +246,28 @@ bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), cached_url)) {
+  if (!GetCachedResult(*url, /*record_lookup=*/true, cached_url))
+    return false;
+
+  if (!cached_url->empty())
     AddHTTPSEUrlToRedirectList(request_identifier);
-    return true;
+  return true;
+}
+
+bool HTTPSEverywhereService::GetCachedResult(const GURL& url,
+                                             bool record_lookup,
+                                             std::string* new_url) {
+  ResultCacheLookup lookup = ResultCacheLookup::kMiss;
+  if (recently_used_cache_.get(url.host(), new_url)) {
+    new_url->clear();
+    lookup = ResultCacheLookup::kNegativeHostHit;
+  } else if (recently_used_cache_.get(url.spec(), new_url)) {
+    lookup = new_url->empty() ? ResultCacheLookup::kNegativeUrlHit
+                              : ResultCacheLookup::kHit;
   }
-  return false;
+  if (record_lookup)
+    UMA_HISTOGRAM_ENUMERATION("Brave.HTTPSE.ResultCacheLookup", lookup);
+  return lookup != ResultCacheLookup::kMiss;
 }
 
 bool HTTPSEverywhereService::ShouldHTTPSERedirect(
@@ -262,116 +312,23 @@ void HTTPSEverywhereService::AddHTTPSEUrlToRedirectList(
   }
 }
 
-std::string HTTPSEverywhereService::ApplyHTTPSRule(
-    const std::string& originalUrl,
-    const std::string& rule) {
-  base::Optional<base::Value> json_object = base::JSONReader::Read(rule);
-  if (base::nullopt == json_object || !json_object->is_list()) {
-    return "";
-  }
-
-  base::Value::ConstListView topValues = json_object->GetList();
-  for (auto it = topValues.cbegin(); it != topValues.cend(); ++it) {
-    if (!it->is_dict()) {
-      continue;
-    }
-    const base::DictionaryValue* childTopDictionary = nullptr;
-    it->GetAsDictionary(&childTopDictionary);
-    if (nullptr == childTopDictionary) {
-      continue;
-    }
-
-    const base::Value* exclusion = nullptr;
-    if (childTopDictionary->Get("e", &exclusion)) {
-      const base::ListValue* eValues = nullptr;
-      exclusion->GetAsList(&eValues);
-      if (nullptr != eValues) {
-        for (size_t j = 0; j < eValues->GetSize(); ++j) {
-          const base::Value* pValue = nullptr;
-          if (!eValues->Get(j, &pValue)) {
-            continue;
-          }
-          const base::DictionaryValue* pDictionary = nullptr;
-          pValue->GetAsDictionary(&pDictionary);
-          if (nullptr == pDictionary) {
-            continue;
-          }
-          const base::Value* patternValue = nullptr;
-          if (!pDictionary->Get("p", &patternValue)) {
-            continue;
-          }
-          std::string pattern;
-          if (!patternValue->GetAsString(&pattern)) {
-            continue;
-          }
-          pattern = CorrecttoRuleToRE2Engine(pattern);
-          if (RE2::FullMatch(originalUrl, pattern)) {
-            return "";
-          }
-        }
-      }
-    }
-
-    const base::Value* rules = nullptr;
-    if (!childTopDictionary->Get("r", &rules)) {
-      return "";
-    }
-    const base::ListValue* rValues = nullptr;
-    rules->GetAsList(&rValues);
-    if (nullptr == rValues) {
-      return "";
-    }
-
-    for (size_t j = 0; j < rValues->GetSize(); ++j) {
-      const base::Value* pValue = nullptr;
-      if (!rValues->Get(j, &pValue)) {
-        continue;
-      }
-      const base::DictionaryValue* pDictionary = nullptr;
-      pValue->GetAsDictionary(&pDictionary);
-      if (nullptr == pDictionary) {
-        continue;
-      }
-      const base::Value* patternValue = nullptr;
-      if (pDictionary->Get("d", &patternValue)) {
-        std::string newUrl(originalUrl);
-        return newUrl.insert(4, "s");
-      }
-
-      const base::Value* from_value = nullptr;
-      const base::Value* to_value = nullptr;
-      if (!pDictionary->Get("f", &from_value) ||
-          !pDictionary->Get("t", &to_value)) {
-        continue;
-      }
-      std::string from, to;
-      if (!from_value->GetAsString(&from) ||
-          !to_value->GetAsString(&to)) {
-        continue;
-      }
-
-      to = CorrecttoRuleToRE2Engine(to);
-      std::string newUrl(originalUrl);
-      RE2 regExp(from);
-
-      if (RE2::Replace(&newUrl, regExp, to) && newUrl != originalUrl) {
-        return newUrl;
-      }
-    }
+const HTTPSEverywhereRuleset* HTTPSEverywhereService::GetRuleset(
+    const std::string& domain) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = recently_used_rulesets_.Get(domain);
+  if (it != recently_used_rulesets_.end()) {
+    return it->second.get();
   }
-  return "";
-}
 
-std::string HTTPSEverywhereService::CorrecttoRuleToRE2Engine(
-    const std::string& to) {
-  std::string correctedto(to);
-  size_t pos = to.find("$");
-  while (std::string::npos != pos) {
-    correctedto[pos] = '\\';
-    pos = correctedto.find("$");
+  std::string value = leveldbGet(level_db_, domain);
+  if (value.empty()) {
+    return nullptr;
   }
-
-  return correctedto;
+  std::unique_ptr<HTTPSEverywhereRuleset> ruleset =
+      HTTPSEverywhereRuleset::FromJSON(value);
+  const HTTPSEverywhereRuleset* result = ruleset.get();
+  recently_used_rulesets_.Put(domain, std::move(ruleset));
+  return result;
 }
 
 void HTTPSEverywhereService::CloseDatabase() {
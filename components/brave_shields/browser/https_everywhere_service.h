@@ -10,12 +10,14 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
 #include "base/synchronization/lock.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
+#include "brave/components/brave_shields/browser/https_everywhere_ruleset.h"
 
 namespace leveldb {
 class DB;
@@ -51,6 +53,8 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
   bool GetHTTPSURL(const GURL* url,
                    const uint64_t& request_id,
                    std::string* new_url);
+  // Returns true if the result for |url| is already known. |cached_url| is
+  // left empty when it is known that no rule upgrades |url|.
   bool GetHTTPSURLFromCacheOnly(const GURL* url,
                                 const uint64_t& request_id,
                                 std::string* cached_url);
@@ -63,9 +67,16 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
 
   void AddHTTPSEUrlToRedirectList(const uint64_t& request_id);
   bool ShouldHTTPSERedirect(const uint64_t& request_id);
-  std::string ApplyHTTPSRule(const std::string& originalUrl,
-      const std::string& rule);
-  std::string CorrecttoRuleToRE2Engine(const std::string& to);
+  // Looks |url| up in |recently_used_cache_|, first as a host known to have
+  // no rules and then as a full URL. Only the first lookup made for a request
+  // should set |record_lookup|, so that each request is counted once.
+  bool GetCachedResult(const GURL& url,
+                       bool record_lookup,
+                       std::string* new_url);
+  // Returns the ruleset stored under |domain| in the database. It is read,
+  // parsed and its patterns compiled on first use, then kept in
+  // |recently_used_rulesets_| until evicted or a new database is loaded.
+  const HTTPSEverywhereRuleset* GetRuleset(const std::string& domain);
 
  private:
   friend class ::HTTPSEverywhereServiceTest;
@@ -84,6 +95,8 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
   base::Lock httpse_get_urls_redirects_count_mutex_;
   std::vector<HTTPSE_REDIRECTS_COUNT_ST> httpse_urls_redirects_count_;
   HTTPSERecentlyUsedCache<std::string> recently_used_cache_;
+  base::MRUCache<std::string, std::unique_ptr<HTTPSEverywhereRuleset>>
+      recently_used_rulesets_;
   leveldb::DB* level_db_;
 
   SEQUENCE_CHECKER(sequence_checker_);
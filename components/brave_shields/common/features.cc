@@ -13,6 +13,10 @@ namespace features {
 const base::Feature kBraveAdblockCosmeticFiltering{
     "BraveAdblockCosmeticFiltering",
     base::FEATURE_ENABLED_BY_DEFAULT};
+// When enabled, adblock CNAME uncloaking reuses canonical names from earlier
+// resolutions and only waits for DNS when the original URL was not blocked.
+const base::Feature kBraveAdblockCnameCache{"BraveAdblockCnameCache",
+                                            base::FEATURE_DISABLED_BY_DEFAULT};
 const base::Feature kBraveAdblockCosmeticFilteringNative{
     "BraveAdblockCosmeticFilteringNative", base::FEATURE_DISABLED_BY_DEFAULT};
 // When enabled, Brave will block domains listed in the user's selected adblock
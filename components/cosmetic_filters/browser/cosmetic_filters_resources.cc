@@ -7,9 +7,7 @@
 
 #include <utility>
 
-#include "base/json/json_reader.h"
 #include "base/optional.h"
-#include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
@@ -26,64 +24,40 @@ CosmeticFiltersResources::CosmeticFiltersResources(
 CosmeticFiltersResources::~CosmeticFiltersResources() {}
 
 void CosmeticFiltersResources::HiddenClassIdSelectors(
-    const std::string& input,
-    const std::vector<std::string>& exceptions,
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
     HiddenClassIdSelectorsCallback callback) {
-  base::Optional<base::Value> input_value = base::JSONReader::Read(input);
-  if (!input_value || !input_value->is_dict()) {
-    // Nothing to work with
-    std::move(callback).Run(base::Value());
-
-    return;
-  }
-  base::DictionaryValue* input_dict;
-  if (!input_value->GetAsDictionary(&input_dict)) {
-    std::move(callback).Run(base::Value());
-
-    return;
-  }
-  std::vector<std::string> classes;
-  base::ListValue* classes_list;
-  if (input_dict->GetList("classes", &classes_list)) {
-    for (size_t i = 0; i < classes_list->GetSize(); i++) {
-      if (!classes_list->GetList()[i].is_string()) {
-        continue;
-      }
-      classes.push_back(classes_list->GetList()[i].GetString());
-    }
-  }
-  std::vector<std::string> ids;
-  base::ListValue* ids_list;
-  if (input_dict->GetList("ids", &ids_list)) {
-    for (size_t i = 0; i < ids_list->GetSize(); i++) {
-      if (!ids_list->GetList()[i].is_string()) {
-        continue;
-      }
-      ids.push_back(ids_list->GetList()[i].GetString());
-    }
-  }
-
   ad_block_service_->GetTaskRunner()->PostTaskAndReplyWithResult(
       FROM_HERE,
-      base::BindOnce(&brave_shields::AdBlockService::HiddenClassIdSelectors,
+      base::BindOnce(&brave_shields::AdBlockService::GetHiddenClassIdSelectors,
                      base::Unretained(ad_block_service_), classes, ids,
-                     exceptions),
+                     std::vector<std::string>()),
       base::BindOnce(&CosmeticFiltersResources::HiddenClassIdSelectorsOnUI,
                      weak_factory_.GetWeakPtr(), std::move(callback)));
 }
 
 void CosmeticFiltersResources::HiddenClassIdSelectorsOnUI(
     HiddenClassIdSelectorsCallback callback,
-    base::Optional<base::Value> resources) {
-  std::move(callback).Run(resources ? std::move(resources.value())
-                                    : base::Value());
+    brave_shields::AdBlockHiddenSelectors selectors) {
+  std::move(callback).Run(mojom::HiddenSelectors::New(
+      std::move(selectors.hide_selectors),
+      std::move(selectors.force_hide_selectors), selectors.engine_generation));
 }
 
 void CosmeticFiltersResources::UrlCosmeticResourcesOnUI(
     UrlCosmeticResourcesCallback callback,
-    base::Optional<base::Value> resources) {
-  std::move(callback).Run(resources ? std::move(resources.value())
-                                    : base::Value());
+    base::Optional<brave_shields::AdBlockCosmeticResources> resources) {
+  if (!resources) {
+    std::move(callback).Run(nullptr);
+    return;
+  }
+
+  std::move(callback).Run(mojom::UrlCosmeticResources::New(
+      std::move(resources->hide_selectors),
+      std::move(resources->force_hide_selectors),
+      std::move(resources->style_selectors), std::move(resources->exceptions),
+      std::move(resources->injected_script), resources->generichide,
+      resources->engine_generation));
 }
 
 void CosmeticFiltersResources::ShouldDoCosmeticFiltering(
@@ -102,7 +76,7 @@ void CosmeticFiltersResources::UrlCosmeticResources(
     UrlCosmeticResourcesCallback callback) {
   ad_block_service_->GetTaskRunner()->PostTaskAndReplyWithResult(
       FROM_HERE,
-      base::BindOnce(&brave_shields::AdBlockService::UrlCosmeticResources,
+      base::BindOnce(&brave_shields::AdBlockService::GetCosmeticResources,
                      base::Unretained(ad_block_service_), url),
       base::BindOnce(&CosmeticFiltersResources::UrlCosmeticResourcesOnUI,
                      weak_factory_.GetWeakPtr(), std::move(callback)));
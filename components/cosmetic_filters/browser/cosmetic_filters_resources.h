@@ -12,7 +12,7 @@
 
 #include "base/memory/weak_ptr.h"
 #include "base/optional.h"
-#include "base/values.h"
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources.h"
 #include "brave/components/cosmetic_filters/common/cosmetic_filters.mojom.h"
 
 class HostContentSettingsMap;
@@ -43,8 +43,8 @@ class CosmeticFiltersResources final
 
   // Sends back to renderer a response about rules that has to be applied
   // for the specified selectors.
-  void HiddenClassIdSelectors(const std::string& input,
-                              const std::vector<std::string>& exceptions,
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids,
                               HiddenClassIdSelectorsCallback callback) override;
 
   // Sends back to renderer a response what rules and scripts has to be
@@ -53,11 +53,13 @@ class CosmeticFiltersResources final
                             UrlCosmeticResourcesCallback callback) override;
 
  private:
-  void HiddenClassIdSelectorsOnUI(HiddenClassIdSelectorsCallback callback,
-                                  base::Optional<base::Value> resources);
+  void HiddenClassIdSelectorsOnUI(
+      HiddenClassIdSelectorsCallback callback,
+      brave_shields::AdBlockHiddenSelectors selectors);
 
-  void UrlCosmeticResourcesOnUI(UrlCosmeticResourcesCallback callback,
-                                base::Optional<base::Value> resources);
+  void UrlCosmeticResourcesOnUI(
+      UrlCosmeticResourcesCallback callback,
+      base::Optional<brave_shields::AdBlockCosmeticResources> resources);
 
   HostContentSettingsMap* settings_map_;             // Not owned
   brave_shields::AdBlockService* ad_block_service_;  // Not owned
@@ -0,0 +1,137 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/cosmetic_filters/renderer/class_id_selector_cache.h"
+
+#include <utility>
+
+#include "base/containers/flat_map.h"
+#include "base/strings/string_piece.h"
+
+namespace cosmetic_filters {
+
+namespace {
+
+constexpr size_t kMaxCachedTokens = 10000;
+
+// Generic class and id rules are indexed by the class or id they start with,
+// so every selector returned for a query begins with one of the queried
+// tokens, e.g. ".ad-banner > img" belongs to ".ad-banner".
+base::StringPiece LeadingToken(const std::string& selector) {
+  if (selector.empty() || (selector[0] != '.' && selector[0] != '#'))
+    return base::StringPiece();
+  return base::StringPiece(selector).substr(
+      0, selector.find_first_of(" .#[:>+~,()", 1));
+}
+
+}  // namespace
+
+ClassIdSelectorCache::Entry::Entry() = default;
+
+ClassIdSelectorCache::Entry::Entry(const Entry& other) = default;
+
+ClassIdSelectorCache::Entry::~Entry() = default;
+
+// static
+ClassIdSelectorCache* ClassIdSelectorCache::GetInstance() {
+  static base::NoDestructor<ClassIdSelectorCache> instance;
+  return instance.get();
+}
+
+ClassIdSelectorCache::ClassIdSelectorCache() : entries_(kMaxCachedTokens) {}
+
+ClassIdSelectorCache::~ClassIdSelectorCache() = default;
+
+void ClassIdSelectorCache::Lookup(const std::vector<std::string>& classes,
+                                  const std::vector<std::string>& ids,
+                                  std::vector<std::string>* unseen_classes,
+                                  std::vector<std::string>* unseen_ids,
+                                  mojom::HiddenSelectors* selectors) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+
+  auto lookup = [&](const std::string& key, const std::string& token,
+                    std::vector<std::string>* unseen) {
+    auto it = entries_.Get(key);
+    if (it == entries_.end()) {
+      unseen->push_back(token);
+      return;
+    }
+    selectors->hide_selectors.insert(selectors->hide_selectors.end(),
+                                     it->second.hide_selectors.begin(),
+                                     it->second.hide_selectors.end());
+    selectors->force_hide_selectors.insert(
+        selectors->force_hide_selectors.end(),
+        it->second.force_hide_selectors.begin(),
+        it->second.force_hide_selectors.end());
+  };
+
+  for (const auto& class_name : classes)
+    lookup("." + class_name, class_name, unseen_classes);
+  for (const auto& id : ids)
+    lookup("#" + id, id, unseen_ids);
+}
+
+void ClassIdSelectorCache::Store(const std::vector<std::string>& classes,
+                                 const std::vector<std::string>& ids,
+                                 const mojom::HiddenSelectors& selectors) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+
+  OnEngineGeneration(selectors.engine_generation);
+  // Answers computed by an older engine would be dropped on the next query
+  // anyway, so don't bother caching them.
+  if (selectors.engine_generation != generation_)
+    return;
+
+  base::flat_map<std::string, Entry> answers;
+  for (const auto& class_name : classes)
+    answers.emplace("." + class_name, Entry());
+  for (const auto& id : ids)
+    answers.emplace("#" + id, Entry());
+
+  auto attribute = [&answers](const std::vector<std::string>& from,
+                              bool force_hide) {
+    for (const auto& selector : from) {
+      auto it = answers.find(LeadingToken(selector).as_string());
+      if (it == answers.end())
+        return false;
+      (force_hide ? it->second.force_hide_selectors
+                  : it->second.hide_selectors)
+          .push_back(selector);
+    }
+    return true;
+  };
+  // A selector that can't be attributed (e.g. because of CSS escapes) would
+  // make the other tokens look like they have no rules, so cache nothing.
+  if (!attribute(selectors.hide_selectors, false) ||
+      !attribute(selectors.force_hide_selectors, true)) {
+    return;
+  }
+
+  for (auto& answer : answers)
+    entries_.Put(answer.first, std::move(answer.second));
+}
+
+void ClassIdSelectorCache::OnEngineGeneration(uint64_t generation) {
+  DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
+  if (generation <= generation_)
+    return;
+
+  entries_.Clear();
+  generation_ = generation;
+}
+
+std::vector<std::string> RemoveExceptions(
+    const std::vector<std::string>& selectors,
+    const base::flat_set<std::string>& exceptions) {
+  std::vector<std::string> result;
+  result.reserve(selectors.size());
+  for (const auto& selector : selectors) {
+    if (!exceptions.contains(selector))
+      result.push_back(selector);
+  }
+  return result;
+}
+
+}  // namespace cosmetic_filters
@@ -0,0 +1,82 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_CLASS_ID_SELECTOR_CACHE_H_
+#define BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_CLASS_ID_SELECTOR_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/no_destructor.h"
+#include "base/threading/thread_checker.h"
+#include "brave/components/cosmetic_filters/common/cosmetic_filters.mojom.h"
+
+namespace cosmetic_filters {
+
+// Per renderer process cache of the generic selectors the browser returned
+// for individual classes and ids, shared by every frame in the process. Each
+// answer is stamped with the ad-block engine generation it was computed with,
+// and the whole cache is dropped as soon as a newer generation is seen.
+// Must only be used on the render main thread.
+class ClassIdSelectorCache {
+ public:
+  static ClassIdSelectorCache* GetInstance();
+
+  // Splits |classes| and |ids| into those with a cached answer, whose
+  // selectors are appended to |selectors|, and those that still need to be
+  // queried, which are appended to |unseen_classes| and |unseen_ids|.
+  void Lookup(const std::vector<std::string>& classes,
+              const std::vector<std::string>& ids,
+              std::vector<std::string>* unseen_classes,
+              std::vector<std::string>* unseen_ids,
+              mojom::HiddenSelectors* selectors);
+
+  // Records |selectors| as the complete answer for |classes| and |ids|.
+  void Store(const std::vector<std::string>& classes,
+             const std::vector<std::string>& ids,
+             const mojom::HiddenSelectors& selectors);
+
+  // Drops every cached answer if |generation| is newer than the cache.
+  void OnEngineGeneration(uint64_t generation);
+
+ private:
+  friend class base::NoDestructor<ClassIdSelectorCache>;
+
+  struct Entry {
+    Entry();
+    Entry(const Entry& other);
+    ~Entry();
+
+    std::vector<std::string> hide_selectors;
+    std::vector<std::string> force_hide_selectors;
+  };
+
+  ClassIdSelectorCache();
+  ~ClassIdSelectorCache();
+
+  uint64_t generation_ = 0;
+  // Keyed by ".class" or "#id".
+  base::HashingMRUCache<std::string, Entry> entries_;
+
+  THREAD_CHECKER(thread_checker_);
+
+  DISALLOW_COPY_AND_ASSIGN(ClassIdSelectorCache);
+};
+
+// Returns |selectors| without the ones in |exceptions|. Cached selectors are
+// shared by every frame in the process, so a page's exceptions are applied to
+// them only when they are injected into that page.
+std::vector<std::string> RemoveExceptions(
+    const std::vector<std::string>& selectors,
+    const base::flat_set<std::string>& exceptions);
+
+}  // namespace cosmetic_filters
+
+#endif  // BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_CLASS_ID_SELECTOR_CACHE_H_
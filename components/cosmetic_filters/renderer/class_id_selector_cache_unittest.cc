@@ -0,0 +1,181 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/cosmetic_filters/renderer/class_id_selector_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace cosmetic_filters {
+
+namespace {
+
+mojom::HiddenSelectors MakeSelectors(
+    const std::vector<std::string>& hide_selectors,
+    const std::vector<std::string>& force_hide_selectors,
+    uint64_t engine_generation) {
+  mojom::HiddenSelectors selectors;
+  selectors.hide_selectors = hide_selectors;
+  selectors.force_hide_selectors = force_hide_selectors;
+  selectors.engine_generation = engine_generation;
+  return selectors;
+}
+
+}  // namespace
+
+class ClassIdSelectorCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    // The cache is shared by the whole process, so start every test from an
+    // empty cache at a generation no earlier test has used.
+    generation_ = NewGeneration();
+    cache()->OnEngineGeneration(generation_);
+  }
+
+  ClassIdSelectorCache* cache() { return ClassIdSelectorCache::GetInstance(); }
+
+  static uint64_t NewGeneration() {
+    static uint64_t generation = 0;
+    return ++generation;
+  }
+
+  uint64_t generation_ = 0;
+};
+
+TEST_F(ClassIdSelectorCacheTest, LookupSplitsCachedTokensFromUnseenOnes) {
+  cache()->Store({"ad", "banner"}, {"sponsor"},
+                 MakeSelectors({".ad", ".ad > img", "#sponsor"}, {},
+                               generation_));
+
+  std::vector<std::string> unseen_classes;
+  std::vector<std::string> unseen_ids;
+  mojom::HiddenSelectors selectors;
+  cache()->Lookup({"ad", "banner", "other"}, {"sponsor", "x"},
+                  &unseen_classes, &unseen_ids, &selectors);
+
+  // "banner" is known to have no selectors, so it is not unseen.
+  EXPECT_EQ(std::vector<std::string>({"other"}), unseen_classes);
+  EXPECT_EQ(std::vector<std::string>({"x"}), unseen_ids);
+  EXPECT_EQ(std::vector<std::string>({".ad", ".ad > img", "#sponsor"}),
+            selectors.hide_selectors);
+  EXPECT_TRUE(selectors.force_hide_selectors.empty());
+}
+
+TEST_F(ClassIdSelectorCacheTest, AttributesSelectorsToTheirLeadingToken) {
+  cache()->Store({"ad", "ad-banner"}, {"promo"},
+                 MakeSelectors({".ad-banner > img", ".ad.wide"}, {"#promo"},
+                               generation_));
+
+  std::vector<std::string> unseen_classes;
+  std::vector<std::string> unseen_ids;
+  mojom::HiddenSelectors selectors;
+  cache()->Lookup({"ad-banner"}, {}, &unseen_classes, &unseen_ids,
+                  &selectors);
+  EXPECT_TRUE(unseen_classes.empty());
+  EXPECT_EQ(std::vector<std::string>({".ad-banner > img"}),
+            selectors.hide_selectors);
+
+  selectors = mojom::HiddenSelectors();
+  cache()->Lookup({"ad"}, {"promo"}, &unseen_classes, &unseen_ids,
+                  &selectors);
+  EXPECT_TRUE(unseen_classes.empty());
+  EXPECT_TRUE(unseen_ids.empty());
+  EXPECT_EQ(std::vector<std::string>({".ad.wide"}), selectors.hide_selectors);
+  EXPECT_EQ(std::vector<std::string>({"#promo"}),
+            selectors.force_hide_selectors);
+}
+
+TEST_F(ClassIdSelectorCacheTest, DoNotStoreUnattributableSelectors) {
+  // "div.ad" does not start with a queried token, so the answer for "banner"
+  // can't be trusted to be complete either.
+  cache()->Store({"ad", "banner"}, {},
+                 MakeSelectors({"div.ad"}, {}, generation_));
+
+  std::vector<std::string> unseen_classes;
+  std::vector<std::string> unseen_ids;
+  mojom::HiddenSelectors selectors;
+  cache()->Lookup({"ad", "banner"}, {}, &unseen_classes, &unseen_ids,
+                  &selectors);
+
+  EXPECT_EQ(std::vector<std::string>({"ad", "banner"}), unseen_classes);
+  EXPECT_TRUE(selectors.hide_selectors.empty());
+}
+
+TEST_F(ClassIdSelectorCacheTest, DropEntriesOnNewerEngineGeneration) {
+  cache()->Store({"ad"}, {}, MakeSelectors({".ad"}, {}, generation_));
+
+  // Older or current generations keep the cache.
+  cache()->OnEngineGeneration(generation_ - 1);
+  cache()->OnEngineGeneration(generation_);
+
+  std::vector<std::string> unseen_classes;
+  std::vector<std::string> unseen_ids;
+  mojom::HiddenSelectors selectors;
+  cache()->Lookup({"ad"}, {}, &unseen_classes, &unseen_ids, &selectors);
+  EXPECT_TRUE(unseen_classes.empty());
+
+  generation_ = NewGeneration();
+  cache()->OnEngineGeneration(generation_);
+
+  selectors = mojom::HiddenSelectors();
+  cache()->Lookup({"ad"}, {}, &unseen_classes, &unseen_ids, &selectors);
+  EXPECT_EQ(std::vector<std::string>({"ad"}), unseen_classes);
+  EXPECT_TRUE(selectors.hide_selectors.empty());
+}
+
+TEST_F(ClassIdSelectorCacheTest, DoNotStoreAnswersFromOlderEngineGeneration) {
+  const uint64_t old_generation = generation_;
+  generation_ = NewGeneration();
+  cache()->OnEngineGeneration(generation_);
+  cache()->Store({"ad"}, {}, MakeSelectors({".ad"}, {}, old_generation));
+
+  std::vector<std::string> unseen_classes;
+  std::vector<std::string> unseen_ids;
+  mojom::HiddenSelectors selectors;
+  cache()->Lookup({"ad"}, {}, &unseen_classes, &unseen_ids, &selectors);
+
+  EXPECT_EQ(std::vector<std::string>({"ad"}), unseen_classes);
+}
+
+TEST_F(ClassIdSelectorCacheTest, StoreNewerEngineGenerationDropsEntries) {
+  cache()->Store({"ad"}, {}, MakeSelectors({".ad"}, {}, generation_));
+  generation_ = NewGeneration();
+  cache()->Store({"banner"}, {}, MakeSelectors({".banner"}, {}, generation_));
+
+  std::vector<std::string> unseen_classes;
+  std::vector<std::string> unseen_ids;
+  mojom::HiddenSelectors selectors;
+  cache()->Lookup({"ad", "banner"}, {}, &unseen_classes, &unseen_ids,
+                  &selectors);
+
+  EXPECT_EQ(std::vector<std::string>({"ad"}), unseen_classes);
+  EXPECT_EQ(std::vector<std::string>({".banner"}), selectors.hide_selectors);
+}
+
+TEST_F(ClassIdSelectorCacheTest, ExceptionsAreAppliedOutsideTheCache) {
+  cache()->Store({"ad", "banner"}, {},
+                 MakeSelectors({".ad", ".banner"}, {".ad > img"},
+                               generation_));
+
+  std::vector<std::string> unseen_classes;
+  std::vector<std::string> unseen_ids;
+  mojom::HiddenSelectors selectors;
+  cache()->Lookup({"ad", "banner"}, {}, &unseen_classes, &unseen_ids,
+                  &selectors);
+
+  // Another page may have no exceptions, so the cache keeps every selector.
+  EXPECT_EQ(std::vector<std::string>({".ad", ".banner"}),
+            selectors.hide_selectors);
+
+  const base::flat_set<std::string> exceptions = {".ad", ".ad > img"};
+  EXPECT_EQ(std::vector<std::string>({".banner"}),
+            RemoveExceptions(selectors.hide_selectors, exceptions));
+  EXPECT_TRUE(
+      RemoveExceptions(selectors.force_hide_selectors, exceptions).empty());
+}
+
+}  // namespace cosmetic_filters
@@ -8,10 +8,12 @@
 #include <utility>
 
 #include "base/bind.h"
-#include "base/json/json_writer.h"
+#include "base/containers/flat_map.h"
+#include "base/json/string_escape.h"
 #include "base/no_destructor.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "brave/components/cosmetic_filters/renderer/class_id_selector_cache.h"
 #include "brave/components/cosmetic_filters/resources/grit/cosmetic_filters_generated_map.h"
 #include "content/public/renderer/render_frame.h"
 #include "gin/arguments.h"
@@ -153,6 +155,35 @@ const char kStyleSelectorsInjectScript[] =
           };
         })();)";
 
+// Serializes |strings| as a JSON array of strings.
+std::string ToJSONArray(const std::vector<std::string>& strings) {
+  std::string json = "[";
+  for (size_t i = 0; i < strings.size(); i++) {
+    if (i != 0)
+      json.push_back(',');
+    base::EscapeJSONString(strings[i], true, &json);
+  }
+  json.push_back(']');
+  return json;
+}
+
+// Serializes |style_selectors| as a JSON object mapping each selector to its
+// array of CSS declarations.
+std::string ToJSONObject(
+    const base::flat_map<std::string, std::vector<std::string>>&
+        style_selectors) {
+  std::string json = "{";
+  for (const auto& style_selector : style_selectors) {
+    if (json.size() != 1)
+      json.push_back(',');
+    base::EscapeJSONString(style_selector.first, true, &json);
+    json.push_back(':');
+    json.append(ToJSONArray(style_selector.second));
+  }
+  json.push_back('}');
+  return json;
+}
+
 std::string LoadDataResource(const int id) {
   auto& resource_bundle = ui::ResourceBundle::GetSharedInstance();
   if (resource_bundle.IsGzipped(id)) {
@@ -200,14 +231,28 @@ CosmeticFiltersJSHandler::CosmeticFiltersJSHandler(
 CosmeticFiltersJSHandler::~CosmeticFiltersJSHandler() = default;
 
 void CosmeticFiltersJSHandler::HiddenClassIdSelectors(
-    const std::string& input) {
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids) {
   if (!EnsureConnected())
     return;
 
+  // Answer what we can from the process-wide cache and only ask the browser
+  // about classes and ids it has not been asked about before.
+  std::vector<std::string> unseen_classes;
+  std::vector<std::string> unseen_ids;
+  cosmetic_filters::mojom::HiddenSelectors cached;
+  ClassIdSelectorCache::GetInstance()->Lookup(classes, ids, &unseen_classes,
+                                              &unseen_ids, &cached);
+  if (!cached.hide_selectors.empty() || !cached.force_hide_selectors.empty())
+    ApplyHiddenSelectors(cached);
+
+  if (unseen_classes.empty() && unseen_ids.empty())
+    return;
+
   cosmetic_filters_resources_->HiddenClassIdSelectors(
-      input, exceptions_,
+      unseen_classes, unseen_ids,
       base::BindOnce(&CosmeticFiltersJSHandler::OnHiddenClassIdSelectors,
-                     base::Unretained(this)));
+                     base::Unretained(this), unseen_classes, unseen_ids));
 }
 
 void CosmeticFiltersJSHandler::AddJavaScriptObjectToFrame(
@@ -276,7 +321,7 @@ bool CosmeticFiltersJSHandler::EnsureConnected() {
 
 void CosmeticFiltersJSHandler::ProcessURL(const GURL& url,
                                           base::OnceClosure callback) {
-  resources_dict_.reset();
+  resources_.reset();
   url_ = url;
   // Trivially, don't make exceptions for malformed URLs.
   if (!EnsureConnected() || url_.is_empty() || !url_.is_valid())
@@ -304,25 +349,24 @@ void CosmeticFiltersJSHandler::OnShouldDoCosmeticFiltering(
 
 void CosmeticFiltersJSHandler::OnUrlCosmeticResources(
     base::OnceClosure callback,
-    base::Value result) {
-  resources_dict_ = base::DictionaryValue::From(
-      base::Value::ToUniquePtrValue(std::move(result)));
+    cosmetic_filters::mojom::UrlCosmeticResourcesPtr resources) {
+  if (resources) {
+    ClassIdSelectorCache::GetInstance()->OnEngineGeneration(
+        resources->engine_generation);
+  }
+  resources_ = std::move(resources);
   std::move(callback).Run();
 }
 
 void CosmeticFiltersJSHandler::ApplyRules() {
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  if (!resources_dict_ || web_frame->IsProvisional())
+  if (!resources_ || web_frame->IsProvisional())
     return;
 
-  std::string scriptlet_script;
-  base::Value* injected_script = resources_dict_->FindPath("injected_script");
-  if (injected_script &&
-      base::JSONWriter::Write(*injected_script, &scriptlet_script)) {
-    scriptlet_script =
-        base::StringPrintf(kScriptletInitScript, scriptlet_script.c_str());
-  }
-  if (!scriptlet_script.empty()) {
+  if (!resources_->injected_script.empty()) {
+    std::string scriptlet_script = base::StringPrintf(
+        kScriptletInitScript,
+        base::GetQuotedJSONString(resources_->injected_script).c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(scriptlet_script));
   }
@@ -330,11 +374,9 @@ void CosmeticFiltersJSHandler::ApplyRules() {
     return;
 
   // Working on css rules, we do that on a main frame only
-  bool generichide = false;
-  resources_dict_->GetBoolean("generichide", &generichide);
   std::string cosmetic_filtering_init_script = base::StringPrintf(
       kCosmeticFilteringInitScript, enabled_1st_party_cf_ ? "true" : "false",
-      generichide ? "true" : "false");
+      resources_->generichide ? "true" : "false");
   std::string pre_init_script = base::StringPrintf(
       kPreInitScript, cosmetic_filtering_init_script.c_str());
 
@@ -343,113 +385,80 @@ void CosmeticFiltersJSHandler::ApplyRules() {
   web_frame->ExecuteScriptInIsolatedWorld(
       isolated_world_id_, blink::WebString::FromUTF8(*g_observing_script));
 
-  CSSRulesRoutine(resources_dict_.get());
+  CSSRulesRoutine(*resources_);
 }
 
 void CosmeticFiltersJSHandler::CSSRulesRoutine(
-    base::DictionaryValue* resources_dict) {
+    const cosmetic_filters::mojom::UrlCosmeticResources& resources) {
   // Otherwise, if its a vetted engine AND we're not in aggressive
   // mode, also don't do cosmetic filtering.
   if (!enabled_1st_party_cf_ && IsVettedSearchEngine(url_))
     return;
 
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  base::ListValue* cf_exceptions_list;
-  if (resources_dict->GetList("exceptions", &cf_exceptions_list)) {
-    for (size_t i = 0; i < cf_exceptions_list->GetSize(); i++) {
-      exceptions_.push_back(cf_exceptions_list->GetList()[i].GetString());
-    }
-  }
-  base::ListValue* hide_selectors_list;
-  if (!resources_dict->GetList("hide_selectors", &hide_selectors_list)) {
-    hide_selectors_list = nullptr;
-  }
-  base::ListValue* force_hide_selectors_list;
-  if (!resources_dict->GetList("force_hide_selectors",
-                               &force_hide_selectors_list)) {
-    force_hide_selectors_list = nullptr;
-  }
+  exceptions_.insert(resources.exceptions.begin(), resources.exceptions.end());
 
-  if (hide_selectors_list && hide_selectors_list->GetSize() != 0) {
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*hide_selectors_list, &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
-    // Building a script for stylesheet modifications
-    std::string new_selectors_script =
-        base::StringPrintf(kHideSelectorsInjectScript, json_selectors.c_str());
-    web_frame->ExecuteScriptInIsolatedWorld(
-        isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script));
-  }
+  InjectSelectors(resources.hide_selectors, /*force_hide=*/false);
+  InjectSelectors(resources.force_hide_selectors, /*force_hide=*/true);
 
-  if (force_hide_selectors_list && force_hide_selectors_list->GetSize() != 0) {
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*force_hide_selectors_list, &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
-    // Building a script for stylesheet modifications
-    std::string new_selectors_script = base::StringPrintf(
-        kForceHideSelectorsInjectScript, json_selectors.c_str());
+  if (!resources.style_selectors.empty()) {
+    std::string new_selectors_script =
+        base::StringPrintf(kStyleSelectorsInjectScript,
+                           ToJSONObject(resources.style_selectors).c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script));
   }
 
-  base::DictionaryValue* style_selectors_dictionary = nullptr;
-  if (resources_dict->GetDictionary("style_selectors",
-                                    &style_selectors_dictionary)) {
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*style_selectors_dictionary,
-                                 &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
-    std::string new_selectors_script =
-        base::StringPrintf(kStyleSelectorsInjectScript, json_selectors.c_str());
-    if (!json_selectors.empty()) {
-      web_frame->ExecuteScriptInIsolatedWorld(
-          isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script));
-    }
-  }
-
   if (!enabled_1st_party_cf_) {
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(*g_observing_script));
   }
 }
 
-void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(base::Value result) {
+void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    cosmetic_filters::mojom::HiddenSelectorsPtr selectors) {
+  if (!selectors)
+    return;
+
+  ClassIdSelectorCache::GetInstance()->Store(classes, ids, *selectors);
+  ApplyHiddenSelectors(*selectors);
+}
+
+void CosmeticFiltersJSHandler::ApplyHiddenSelectors(
+    const cosmetic_filters::mojom::HiddenSelectors& selectors) {
   // If its a vetted engine AND we're not in aggressive
   // mode, don't do cosmetic filtering.
   if (!enabled_1st_party_cf_ && IsVettedSearchEngine(url_))
     return;
 
-  // We expect a List value from adblock service. That is
-  // an extra check to be sure that adblock file exist and gives us
-  // rules that we expect
-  base::ListValue* selectors_list;
-  if (!result.GetAsList(&selectors_list))
-    return;
-
-  blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  std::string json_selectors;
-  if (!base::JSONWriter::Write(*selectors_list, &json_selectors) ||
-      json_selectors.empty()) {
-    json_selectors = "[]";
-  }
-  // Building a script for stylesheet modifications
-  std::string new_selectors_script =
-      base::StringPrintf(kHideSelectorsInjectScript, json_selectors.c_str());
-  if (selectors_list->GetSize() != 0) {
-    web_frame->ExecuteScriptInIsolatedWorld(
-        isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script));
-  }
+  InjectSelectors(RemoveExceptions(selectors.hide_selectors, exceptions_),
+                  /*force_hide=*/false);
+  InjectSelectors(RemoveExceptions(selectors.force_hide_selectors, exceptions_),
+                  /*force_hide=*/true);
 
   if (!enabled_1st_party_cf_) {
-    web_frame->ExecuteScriptInIsolatedWorld(
+    render_frame_->GetWebFrame()->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(*g_observing_script));
   }
 }
 
+void CosmeticFiltersJSHandler::InjectSelectors(
+    const std::vector<std::string>& selectors,
+    bool force_hide) {
+  if (selectors.empty())
+    return;
+
+  // Building a script for stylesheet modifications
+  const std::string json_selectors = ToJSONArray(selectors);
+  std::string new_selectors_script =
+      force_hide ? base::StringPrintf(kForceHideSelectorsInjectScript,
+                                      json_selectors.c_str())
+                 : base::StringPrintf(kHideSelectorsInjectScript,
+                                      json_selectors.c_str());
+  render_frame_->GetWebFrame()->ExecuteScriptInIsolatedWorld(
+      isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script));
+}
+
 }  // namespace cosmetic_filters
@@ -10,6 +10,8 @@
 #include <string>
 #include <vector>
 
+#include "base/callback.h"
+#include "base/containers/flat_set.h"
 #include "brave/components/cosmetic_filters/common/cosmetic_filters.mojom.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
@@ -50,23 +52,36 @@ class CosmeticFiltersJSHandler {
   void CreateWorkerObject(v8::Isolate* isolate, v8::Local<v8::Context> context);
 
   // A function to be called from JS
-  void HiddenClassIdSelectors(const std::string& input);
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids);
 
   void OnShouldDoCosmeticFiltering(base::OnceClosure callback,
                                    bool enabled,
                                    bool first_party_enabled);
-  void OnUrlCosmeticResources(base::OnceClosure callback, base::Value result);
-  void CSSRulesRoutine(base::DictionaryValue* resources_dict);
-  void OnHiddenClassIdSelectors(base::Value result);
+  void OnUrlCosmeticResources(
+      base::OnceClosure callback,
+      cosmetic_filters::mojom::UrlCosmeticResourcesPtr resources);
+  void CSSRulesRoutine(const cosmetic_filters::mojom::UrlCosmeticResources&
+                           resources);
+  void OnHiddenClassIdSelectors(
+      const std::vector<std::string>& classes,
+      const std::vector<std::string>& ids,
+      cosmetic_filters::mojom::HiddenSelectorsPtr selectors);
+  void ApplyHiddenSelectors(
+      const cosmetic_filters::mojom::HiddenSelectors& selectors);
+  // Adds |selectors| to the cosmetic stylesheet. Force-hidden selectors also
+  // apply to first-party content.
+  void InjectSelectors(const std::vector<std::string>& selectors,
+                       bool force_hide);
 
   content::RenderFrame* render_frame_;
   mojo::Remote<cosmetic_filters::mojom::CosmeticFiltersResources>
       cosmetic_filters_resources_;
   int32_t isolated_world_id_;
   bool enabled_1st_party_cf_;
-  std::vector<std::string> exceptions_;
+  base::flat_set<std::string> exceptions_;
   GURL url_;
-  std::unique_ptr<base::DictionaryValue> resources_dict_;
+  cosmetic_filters::mojom::UrlCosmeticResourcesPtr resources_;
 };
 
 // static